@@ -0,0 +1,101 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+// Counting replacement for the global allocator. Include from exactly one
+// translation unit per binary (like the static members in structured_logger.h).
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+class AllocStats {
+public:
+    struct Snapshot {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Counting is on by default; binaries that only need it on demand switch it off
+    static void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // Each thread owns a slot and updates it without a locked instruction;
+    // threads beyond MAX_THREADS share the last slot with atomic adds.
+    static void record(size_t size) {
+        if (!enabled_.load(std::memory_order_relaxed)) return;
+        Slot* slot = local_slot_;
+        if (!slot) slot = local_slot_ = claim_slot();
+        if (slot == &slots_[MAX_THREADS - 1]) {
+            slot->allocations.fetch_add(1, std::memory_order_relaxed);
+            slot->bytes.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+        slot->allocations.store(slot->allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        slot->bytes.store(slot->bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+
+    static Snapshot snapshot() {
+        Snapshot snap;
+        size_t used = std::min<size_t>(next_slot_.load(std::memory_order_acquire), MAX_THREADS);
+        for (size_t i = 0; i < used; i++) {
+            snap.allocations += slots_[i].allocations.load(std::memory_order_relaxed);
+            snap.bytes += slots_[i].bytes.load(std::memory_order_relaxed);
+        }
+        if (used < MAX_THREADS) {
+            snap.allocations += slots_[MAX_THREADS - 1].allocations.load(std::memory_order_relaxed);
+            snap.bytes += slots_[MAX_THREADS - 1].bytes.load(std::memory_order_relaxed);
+        }
+        return snap;
+    }
+
+private:
+    static constexpr size_t MAX_THREADS = 256;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    static Slot* claim_slot() {
+        size_t index = next_slot_.fetch_add(1, std::memory_order_acq_rel);
+        return &slots_[std::min(index, MAX_THREADS - 1)];
+    }
+
+    static std::atomic<bool> enabled_;
+    static std::atomic<size_t> next_slot_;
+    static Slot slots_[MAX_THREADS];
+    static thread_local Slot* local_slot_;
+};
+
+std::atomic<bool> AllocStats::enabled_{true};
+std::atomic<size_t> AllocStats::next_slot_{0};
+AllocStats::Slot AllocStats::slots_[AllocStats::MAX_THREADS];
+thread_local AllocStats::Slot* AllocStats::local_slot_ = nullptr;
+
+static void* counted_alloc(size_t size) {
+    AllocStats::record(size);
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    AllocStats::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    AllocStats::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+#endif
@@ -5,11 +5,21 @@
 #include <vector>
 #include <map>
 #include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <algorithm>
 #include <unistd.h>
 #include "error_handler.h"
 #include "log_analyzer.h"
+#include "profiler.h"
+#include "metrics.h"
+
+struct ErrorEvent {
+    int64_t time = 0; // Seconds since the epoch
+    std::string service;
+};
 
 class ArchLogManager {
 public:
@@ -32,24 +42,7 @@ public:
         try {
             max_entries = std::clamp(max_entries, 1, 10000); // Prevent resource exhaustion
             std::string cmd = "timeout 30 journalctl -n " + std::to_string(max_entries) + " --no-pager -o short --no-hostname 2>/dev/null";
-            
-            std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-            if (!pipe) {
-                ErrorHandler::handle_system_error("journalctl execution");
-                return logs;
-            }
-            
-            char buffer[2048];
-            int line_count = 0;
-            while (fgets(buffer, sizeof(buffer), pipe.get()) && line_count < max_entries) {
-                buffer[2047] = '\0'; // Ensure null termination
-                std::string line(buffer);
-                LogEntry entry = parse_journal_line(line);
-                if (!entry.timestamp.empty()) {
-                    logs.push_back(std::move(entry));
-                    line_count++;
-                }
-            }
+            logs = read_journal(cmd, max_entries, "journalctl execution");
         } catch (const std::exception& e) {
             ErrorHandler::log_error("Journal log access failed: " + std::string(e.what()), ErrorLevel::WARNING);
         }
@@ -89,57 +82,236 @@ public:
             std::string cmd = "timeout 20 journalctl -u '" + service + "' -n " + 
                             std::to_string(max_entries) + " --no-pager -o short --no-hostname 2>/dev/null";
             
-            std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-            if (!pipe) {
-                ErrorHandler::handle_system_error("service log access for " + service);
-                return logs;
-            }
-            
-            char buffer[2048];
-            int line_count = 0;
-            while (fgets(buffer, sizeof(buffer), pipe.get()) && line_count < max_entries) {
-                buffer[2047] = '\0';
-                std::string line(buffer);
-                LogEntry entry = parse_journal_line(line);
-                if (!entry.timestamp.empty()) {
-                    logs.push_back(std::move(entry));
-                    line_count++;
-                }
-            }
+            logs = read_journal(cmd, max_entries, "service log access for " + service);
         } catch (const std::exception& e) {
             ErrorHandler::log_error("Service log access failed for " + service + ": " + std::string(e.what()), ErrorLevel::WARNING);
         }
         return logs;
     }
     
+    // Journal lines per systemd unit over the last window_seconds, keyed by
+    // unit name ("sshd.service") like the cgroup collector, so log volume can
+    // be set beside resource usage. Only the unit field is requested.
+    static std::map<std::string, size_t> get_unit_log_counts(int64_t window_seconds) {
+        std::map<std::string, size_t> counts;
+        try {
+            window_seconds = std::clamp<int64_t>(window_seconds, 1, 365 * 86400);
+            std::string cmd = "timeout 30 journalctl --since=-" + std::to_string(window_seconds) +
+                              "s -o json --output-fields=_SYSTEMD_UNIT --no-pager 2>/dev/null";
+            read_journal_json(cmd, "unit log counting", [&](const char* line) {
+                std::string unit = json_string_field(line, "_SYSTEMD_UNIT");
+                if (!unit.empty()) counts[unit]++;
+            });
+        } catch (const std::exception& e) {
+            ErrorHandler::log_error("Unit log counting failed: " + std::string(e.what()), ErrorLevel::WARNING);
+        }
+        return counts;
+    }
+
+    // Time and source of every journal entry at priority err or worse over
+    // the last window_seconds, oldest first. The source is the systemd unit,
+    // or the syslog identifier for entries outside any unit (e.g. "kernel").
+    static std::vector<ErrorEvent> get_error_events(int64_t window_seconds) {
+        std::vector<ErrorEvent> events;
+        try {
+            window_seconds = std::clamp<int64_t>(window_seconds, 1, 365 * 86400);
+            std::string cmd = "timeout 30 journalctl -p err --since=-" + std::to_string(window_seconds) +
+                              "s -o json --output-fields=_SYSTEMD_UNIT,SYSLOG_IDENTIFIER --no-pager 2>/dev/null";
+            read_journal_json(cmd, "error event access", [&](const char* line) {
+                std::string timestamp = json_string_field(line, "__REALTIME_TIMESTAMP");
+                if (timestamp.empty()) return;
+                ErrorEvent event;
+                event.time = static_cast<int64_t>(std::strtoll(timestamp.c_str(), nullptr, 10) / 1000000);
+                event.service = json_string_field(line, "_SYSTEMD_UNIT");
+                if (event.service.empty()) event.service = json_string_field(line, "SYSLOG_IDENTIFIER");
+                if (event.service.empty()) event.service = "system";
+                events.push_back(std::move(event));
+            });
+        } catch (const std::exception& e) {
+            ErrorHandler::log_error("Error event access failed: " + std::string(e.what()), ErrorLevel::WARNING);
+        }
+        return events;
+    }
+
+    // Runs a journalctl -o json command and hands fn each entry's line.
+    // Lines longer than the buffer (huge messages) are skipped; callers only
+    // request short fields.
+    template <typename Fn>
+    static void read_journal_json(const std::string& cmd, const std::string& operation, Fn fn) {
+        MetricsTimer query_timer(MetricHistogram::QUERY_SECONDS);
+        std::unique_ptr<FILE, decltype(&pclose)> pipe(nullptr, pclose);
+        {
+            ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+            pipe.reset(popen(cmd.c_str(), "r"));
+        }
+        if (!pipe) {
+            ErrorHandler::handle_system_error(operation);
+            return;
+        }
+
+        char buffer[2048];
+        bool line_start = true;
+        uint64_t lines_seen = 0;
+        ARCHLOG_PROFILE_SCOPE(ProfileStage::PARSE);
+        while (fgets(buffer, sizeof(buffer), pipe.get())) {
+            bool complete = std::strchr(buffer, '\n') != nullptr;
+            bool whole = line_start && complete;
+            line_start = complete;
+            if (!whole) continue;
+            lines_seen++;
+            fn(static_cast<const char*>(buffer));
+        }
+        Metrics::add(MetricCounter::LINES_JOURNAL, lines_seen);
+        Metrics::add(MetricCounter::QUERIES_JOURNAL);
+    }
+
+    // "KEY":"value" from one -o json line, unescaped; \uXXXX (surrogate
+    // pairs included) becomes UTF-8
+    static std::string json_string_field(const char* line, const char* key) {
+        std::string pattern = std::string("\"") + key + "\":\"";
+        const char* p = std::strstr(line, pattern.c_str());
+        if (!p) return "";
+        p += pattern.size();
+        std::string value;
+        while (*p && *p != '"') {
+            if (*p != '\\') {
+                value += *p++;
+                continue;
+            }
+            char escaped = p[1];
+            if (!escaped) break;
+            p += 2;
+            switch (escaped) {
+                case 'n': value += '\n'; break;
+                case 't': value += '\t'; break;
+                case 'r': value += '\r'; break;
+                case 'b': value += '\b'; break;
+                case 'f': value += '\f'; break;
+                case 'u': {
+                    uint32_t code = 0;
+                    if (!parse_hex4(p, code)) return value;
+                    p += 4;
+                    uint32_t low = 0;
+                    if (code >= 0xD800 && code < 0xDC00 && p[0] == '\\' && p[1] == 'u' && parse_hex4(p + 2, low) &&
+                        low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    append_utf8(value, code);
+                    break;
+                }
+                default: value += escaped; break; // \" \\ \/
+            }
+        }
+        return value;
+    }
+
+    static bool parse_hex4(const char* p, uint32_t& code) {
+        code = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = p[i];
+            int digit = c >= '0' && c <= '9' ? c - '0'
+                      : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) return false;
+            code = code << 4 | static_cast<uint32_t>(digit);
+        }
+        return true;
+    }
+
+    // A lone surrogate is written as U+FFFD
+    static void append_utf8(std::string& out, uint32_t code) {
+        if (code >= 0xD800 && code < 0xE000) code = 0xFFFD;
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | code >> 6);
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | code >> 12);
+            out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | code >> 18);
+            out += static_cast<char>(0x80 | (code >> 12 & 0x3F));
+            out += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
     static std::vector<LogEntry> get_boot_logs() {
         std::vector<LogEntry> logs;
         try {
-            std::unique_ptr<FILE, decltype(&pclose)> pipe(
-                popen("timeout 60 journalctl -b --no-pager -o short --no-hostname -n 1000 2>/dev/null", "r"), pclose);
-            if (!pipe) {
-                ErrorHandler::handle_system_error("boot log access");
-                return logs;
+            logs = read_journal("timeout 60 journalctl -b --no-pager -o short --no-hostname -n 1000 2>/dev/null",
+                                1000, "boot log access");
+        } catch (const std::exception& e) {
+            ErrorHandler::log_error("Boot log access failed: " + std::string(e.what()), ErrorLevel::WARNING);
+        }
+        return logs;
+    }
+
+    // Runs journalctl and parses its -o short output in batches, so the
+    // profiler can attribute time to fetching and parsing separately.
+    static std::vector<LogEntry> read_journal(const std::string& cmd, int max_entries, const std::string& operation) {
+        static constexpr size_t BATCH_LINES = 256;
+        MetricsTimer query_timer(MetricHistogram::QUERY_SECONDS);
+        std::vector<LogEntry> logs;
+        std::unique_ptr<FILE, decltype(&pclose)> pipe(nullptr, pclose);
+        {
+            ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+            pipe.reset(popen(cmd.c_str(), "r"));
+        }
+        if (!pipe) {
+            ErrorHandler::handle_system_error(operation);
+            return logs;
+        }
+        
+        std::vector<std::string> batch(BATCH_LINES);
+        char buffer[2048];
+        bool eof = false;
+        uint64_t bytes_read = 0, lines_seen = 0, parse_failures = 0;
+        while (!eof && static_cast<int>(logs.size()) < max_entries) {
+            size_t count = 0;
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+                while (count < BATCH_LINES) {
+                    if (!fgets(buffer, sizeof(buffer), pipe.get())) {
+                        eof = true;
+                        break;
+                    }
+                    buffer[2047] = '\0'; // Ensure null termination
+                    batch[count].assign(buffer);
+                    bytes_read += batch[count].size();
+                    count++;
+                }
             }
             
-            char buffer[2048];
-            int line_count = 0;
-            while (fgets(buffer, sizeof(buffer), pipe.get()) && line_count < 1000) {
-                buffer[2047] = '\0';
-                std::string line(buffer);
-                LogEntry entry = parse_journal_line(line);
+            ARCHLOG_PROFILE_SCOPE(ProfileStage::PARSE);
+            for (size_t i = 0; i < count && static_cast<int>(logs.size()) < max_entries; i++) {
+                lines_seen++;
+                LogEntry entry = parse_journal_line(batch[i]);
                 if (!entry.timestamp.empty()) {
                     logs.push_back(std::move(entry));
-                    line_count++;
+                } else {
+                    parse_failures++;
                 }
             }
-        } catch (const std::exception& e) {
-            ErrorHandler::log_error("Boot log access failed: " + std::string(e.what()), ErrorLevel::WARNING);
         }
+        {
+            ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+            pipe.reset(); // pclose() waits for journalctl to exit
+        }
+        
+        ARCHLOG_PROFILE_COUNT(ProfileCounter::BYTES_READ, bytes_read);
+        ARCHLOG_PROFILE_COUNT(ProfileCounter::LINES_SEEN, lines_seen);
+        ARCHLOG_PROFILE_COUNT(ProfileCounter::LINES_PARSED, logs.size());
+        ARCHLOG_PROFILE_COUNT(ProfileCounter::PARSE_FAILURES, parse_failures);
+        Metrics::add(MetricCounter::LINES_JOURNAL, lines_seen);
+        Metrics::add(MetricCounter::PARSE_FAILURES_JOURNAL, parse_failures);
+        Metrics::add(MetricCounter::QUERIES_JOURNAL);
         return logs;
     }
-
-private:
+    
     static LogEntry parse_journal_line(const std::string& line) {
         LogEntry entry;
         if (line.length() < 20) return entry;
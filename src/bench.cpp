@@ -0,0 +1,407 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "alloc_stats.h"
+#include "log_analyzer.h"
+#include "arch_log_manager.h"
+#include "hardware_monitor.h"
+#include "process_stats.h"
+#include "correlation.h"
+#include "structured_logger.h"
+#include "journal_formatter.h"
+#include "output_sink.h"
+#include "log_generator.h"
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double ns_per_op = 0.0;
+    double bytes_per_op = 0.0;
+    double allocs_per_op = 0.0;
+    double mb_per_s = 0.0;
+};
+
+template <typename T>
+static void keep(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+class BenchRunner {
+public:
+    BenchRunner(const std::string& filter, double min_time) : filter_(filter), min_time_(min_time) {}
+
+    // fn(i) performs one operation; input_bytes is the payload consumed per op
+    // (0 = no MB/s). False when the filter skipped it.
+    template <typename Fn>
+    bool run(const std::string& name, double input_bytes, Fn fn) {
+        return run(name, input_bytes, fn, 0, [] {});
+    }
+
+    // As above, with between() called untimed after every batch operations,
+    // for operations that fill something (a bounded queue) only it empties
+    template <typename Fn, typename Between>
+    bool run(const std::string& name, double input_bytes, Fn fn, uint64_t batch, Between between) {
+        if (!filter_.empty() && name.find(filter_) == std::string::npos) return false;
+
+        int saved_stderr = silence_stderr();
+        fn(0); // Warm caches and lazily initialized state
+        between();
+
+        uint64_t iterations = 1;
+        double elapsed = 0.0;
+        uint64_t bytes = 0, allocations = 0;
+        while (true) {
+            elapsed = 0.0;
+            bytes = allocations = 0;
+            for (uint64_t i = 0; i < iterations;) {
+                uint64_t end = batch > 0 ? std::min(iterations, i + batch) : iterations;
+                AllocStats::Snapshot before = AllocStats::snapshot();
+                auto start = std::chrono::steady_clock::now();
+                for (; i < end; i++) {
+                    fn(i);
+                }
+                elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                AllocStats::Snapshot after = AllocStats::snapshot();
+                bytes += after.bytes - before.bytes;
+                allocations += after.allocations - before.allocations;
+                if (batch > 0) between();
+            }
+            if (elapsed >= min_time_ || iterations >= (1ULL << 30)) break;
+            iterations = elapsed > 0.0 ? std::max(iterations * 2, static_cast<uint64_t>(iterations * min_time_ * 1.2 / elapsed))
+                                       : iterations * 10;
+        }
+        restore_stderr(saved_stderr);
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.ns_per_op = elapsed * 1e9 / iterations;
+        result.bytes_per_op = static_cast<double>(bytes) / iterations;
+        result.allocs_per_op = static_cast<double>(allocations) / iterations;
+        result.mb_per_s = input_bytes > 0.0 ? input_bytes * iterations / elapsed / (1024.0 * 1024.0) : 0.0;
+        print(result);
+        results_.push_back(result);
+        return true;
+    }
+
+    void section(const std::string& title) const {
+        std::printf("\n=== %s ===\n", title.c_str());
+        std::printf("%-40s %12s %12s %10s %10s\n", "benchmark", "ns/op", "B/op", "allocs/op", "MB/s");
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+private:
+    static void print(const BenchResult& r) {
+        std::printf("%-40s %12.1f %12.1f %10.2f %10.1f\n", r.name.c_str(), r.ns_per_op, r.bytes_per_op,
+                    r.allocs_per_op, r.mb_per_s);
+        std::fflush(stdout);
+    }
+
+    // Collectors log failures to stderr on every call; keep the table readable
+    static int silence_stderr() {
+        std::cerr.flush();
+        int saved = dup(STDERR_FILENO);
+        int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (devnull >= 0) {
+            dup2(devnull, STDERR_FILENO);
+            close(devnull);
+        }
+        return saved;
+    }
+
+    static void restore_stderr(int saved) {
+        if (saved < 0) return;
+        std::cerr.flush();
+        dup2(saved, STDERR_FILENO);
+        close(saved);
+    }
+
+    std::string filter_;
+    double min_time_;
+    std::vector<BenchResult> results_;
+};
+
+// Fixed seeded corpora so runs are comparable across commits and machines
+static std::vector<std::string> corpus(LogFormat format, size_t count, bool keep_newline) {
+    LogGeneratorConfig config;
+    config.format = format;
+    config.seed = 42;
+    auto lines = LogGenerator(config).lines(count);
+    if (!keep_newline) {
+        for (auto& line : lines) line.pop_back();
+    }
+    return lines;
+}
+
+template <typename Format>
+static size_t sink_to_null(int fd, const std::vector<LogEntry>& entries) {
+    OutputBuffer out(fd);
+    OutputSink<Format>::write(out, entries);
+    return out.bytes_written();
+}
+
+// Records a logger bench lost to a full queue; nonzero means its ns/op
+// timed drops as well as enqueues
+static constexpr uint64_t LOG_BATCH = StructuredLogger::MAX_PENDING / 16;
+
+static void report_drops(uint64_t dropped_before) {
+    std::printf("%-40s %llu records dropped\n", "",
+                static_cast<unsigned long long>(StructuredLogger::dropped_records() - dropped_before));
+}
+
+static double average_size(const std::vector<std::string>& lines) {
+    size_t total = 0;
+    for (const auto& line : lines) total += line.size();
+    return lines.empty() ? 0.0 : static_cast<double>(total) / lines.size();
+}
+
+static std::string json_escape(const std::string& str) {
+    std::string out;
+    for (char c : str) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static void write_json(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        ErrorHandler::handle_file_error(path, "write");
+        return;
+    }
+    out << "{\"benchmarks\":[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "  {\"name\":\"" << json_escape(r.name) << "\",\"iterations\":" << r.iterations
+            << ",\"ns_per_op\":" << r.ns_per_op << ",\"bytes_per_op\":" << r.bytes_per_op
+            << ",\"allocs_per_op\":" << r.allocs_per_op << ",\"mb_per_s\":" << r.mb_per_s << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+}
+
+// Reads ns_per_op per benchmark back from a file written by write_json
+static std::map<std::string, double> read_json(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        ErrorHandler::handle_file_error(path, "read");
+        return baseline;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string name = JournalFormatter::extract_json_field(line, "name");
+        size_t pos = line.find("\"ns_per_op\":");
+        if (name.empty() || pos == std::string::npos) continue;
+        baseline[name] = std::strtod(line.c_str() + pos + 12, nullptr);
+    }
+    return baseline;
+}
+
+static void print_comparison(const std::map<std::string, double>& baseline, const std::vector<BenchResult>& results) {
+    std::printf("\n=== Comparison (ns/op) ===\n");
+    std::printf("%-40s %12s %12s %9s\n", "benchmark", "baseline", "current", "delta");
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0.0) continue;
+        double delta = (r.ns_per_op - it->second) * 100.0 / it->second;
+        std::printf("%-40s %12.1f %12.1f %+8.1f%%\n", r.name.c_str(), it->second, r.ns_per_op, delta);
+    }
+}
+
+static void print_usage() {
+    std::cout << "ArchVault benchmark suite\n";
+    std::cout << "Usage: archlog-bench [options]\n";
+    std::cout << "  --filter=SUBSTR  Run only benchmarks whose name contains SUBSTR\n";
+    std::cout << "  --min-time=SEC   Minimum measured time per benchmark (default 0.2)\n";
+    std::cout << "  --json=FILE      Write results as JSON\n";
+    std::cout << "  --compare=FILE   Compare against a previous JSON result\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter, json_path, compare_path;
+    double min_time = 0.2;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.find("--filter=") == 0) {
+            filter = arg.substr(9);
+        } else if (arg.find("--min-time=") == 0) {
+            min_time = std::clamp(std::atof(arg.c_str() + 11), 0.001, 60.0);
+        } else if (arg.find("--json=") == 0) {
+            json_path = arg.substr(7);
+        } else if (arg.find("--compare=") == 0) {
+            compare_path = arg.substr(10);
+        } else {
+            print_usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    BenchRunner bench(filter, min_time);
+    const auto syslog = corpus(LogFormat::SYSLOG, 4096, false);     // getline() strips the newline
+    const auto journal = corpus(LogFormat::JOURNAL_SHORT, 4096, true); // fgets() keeps it
+    const auto json = corpus(LogFormat::JOURNAL_JSON, 4096, true);
+    std::vector<LogEntry> entries;
+    for (size_t i = 0; i < 1000; i++) {
+        entries.push_back(ArchLogManager::parse_journal_line(journal[i]));
+    }
+    const size_t mask = 4095;
+
+    bench.section("Parsing");
+    bench.run("LogAnalyzer::parse_log_line", average_size(syslog), [&](uint64_t i) {
+        keep(LogAnalyzer::parse_log_line(syslog[i & mask]));
+    });
+    bench.run("ArchLogManager::parse_journal_line", average_size(journal), [&](uint64_t i) {
+        keep(ArchLogManager::parse_journal_line(journal[i & mask]));
+    });
+    bench.run("LogAnalyzer::filter_by_level/1000", 0.0, [&](uint64_t) {
+        keep(LogAnalyzer::filter_by_level(entries, "ERROR"));
+    });
+
+    LogGeneratorConfig generator_config;
+    LogGenerator generator(generator_config);
+    char line_buffer[LogGenerator::MAX_LINE + 512];
+    bench.run("LogGenerator::next_line", average_size(syslog), [&](uint64_t) {
+        keep(generator.next_line(line_buffer));
+    });
+
+    bench.section("GUI formatting");
+    bench.run("JournalFormatter::extract_json_field", average_size(json), [&](uint64_t i) {
+        keep(JournalFormatter::extract_json_field(json[i & mask], "MESSAGE"));
+    });
+    bench.run("JournalFormatter::format_log_entry", average_size(json), [&](uint64_t i) {
+        keep(JournalFormatter::format_log_entry(json[i & mask], static_cast<int>(i & mask)));
+    });
+
+    bench.section("Structured logging");
+    StructuredLogEntry log_entry;
+    log_entry.timestamp = "2024-01-01 12:00:00.123";
+    log_entry.log_name = "perf_analysis";
+    log_entry.directory = "/gui";
+    log_entry.level = LogLevel::INFO;
+    log_entry.category = LogCategory::PERFORMANCE;
+    log_entry.message = "Performance analysis completed for \"session\"\twith\nnewlines";
+    log_entry.source_file = "modern_gui.cpp";
+    log_entry.line_number = 1114;
+    log_entry.user = "arch";
+    log_entry.session_id = "sess_1700000000000";
+    log_entry.metadata = {{"cpu_usage", "12.500000"}, {"memory_usage", "48.250000"}, {"disk_usage", "71.000000"}};
+    bench.run("StructuredLogEntry::to_json", 0.0, [&](uint64_t) {
+        keep(log_entry.to_json());
+    });
+    bench.run("StructuredLogEntry::to_formatted_string", 0.0, [&](uint64_t) {
+        keep(log_entry.to_formatted_string());
+    });
+    std::string log_buffer; // The writer thread's case: one buffer reused for every record
+    bench.run("StructuredLogEntry::append_json", 0.0, [&](uint64_t) {
+        log_buffer.clear();
+        log_entry.append_json(log_buffer);
+        keep(log_buffer);
+    });
+    bench.run("StructuredLogEntry::append_formatted", 0.0, [&](uint64_t) {
+        log_buffer.clear();
+        log_entry.append_formatted(log_buffer);
+        keep(log_buffer);
+    });
+    // Caller-side cost only; the writer formats and discards (no console, no
+    // file). Batches stay below MAX_PENDING and the queue is drained untimed
+    // between them, so every timed call is a real enqueue, not a drop.
+    StructuredLogger::initialize("bench", "");
+    StructuredLogger::set_console_output(false);
+    uint64_t dropped_before = StructuredLogger::dropped_records();
+    if (bench.run("StructuredLogger::info (enqueue)", 0.0, [&](uint64_t) {
+            StructuredLogger::info("perf_analysis", "/gui", "Analysis completed");
+        }, LOG_BATCH, StructuredLogger::flush)) {
+        report_drops(dropped_before);
+    }
+    dropped_before = StructuredLogger::dropped_records();
+    if (bench.run("ARCHLOG_INFO (deferred format)", 0.0, [&](uint64_t i) {
+            ARCHLOG_INFO("perf_analysis", "/gui", "Analysis completed: {} entries in {} s", i, 0.25);
+        }, LOG_BATCH, StructuredLogger::flush)) {
+        report_drops(dropped_before);
+    }
+    bench.run("ARCHLOG_DEBUG (below min level)", 0.0, [&](uint64_t i) {
+        ARCHLOG_DEBUG("perf_analysis", "/gui", "Analysis completed: {} entries in {} s", i, 0.25);
+    });
+    StructuredLogger::flush();
+
+    bench.section("Output sinks (/dev/null, 1000 entries/op)");
+    int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    size_t text_bytes = sink_to_null<TextFormat>(devnull, entries);
+    size_t csv_bytes = sink_to_null<CsvFormat>(devnull, entries);
+    size_t ndjson_bytes = sink_to_null<NdjsonFormat>(devnull, entries);
+    bench.run("OutputSink<TextFormat>", text_bytes, [&](uint64_t) {
+        keep(sink_to_null<TextFormat>(devnull, entries));
+    });
+    bench.run("OutputSink<CsvFormat>", csv_bytes, [&](uint64_t) {
+        keep(sink_to_null<CsvFormat>(devnull, entries));
+    });
+    bench.run("OutputSink<NdjsonFormat>", ndjson_bytes, [&](uint64_t) {
+        keep(sink_to_null<NdjsonFormat>(devnull, entries));
+    });
+    close(devnull);
+
+    bench.section("Hardware collectors");
+    bench.run("HardwareMonitor::get_memory_usage", 0.0, [](uint64_t) { keep(HardwareMonitor::get_memory_usage()); });
+    bench.run("HardwareMonitor::get_disk_usage", 0.0, [](uint64_t) { keep(HardwareMonitor::get_disk_usage()); });
+    bench.run("HardwareMonitor::get_system_load", 0.0, [](uint64_t) { keep(HardwareMonitor::get_system_load()); });
+    bench.run("HardwareMonitor::get_active_connections", 0.0, [](uint64_t) { keep(HardwareMonitor::get_active_connections()); });
+    bench.run("HardwareMonitor::get_cpu_temperature", 0.0, [](uint64_t) { keep(HardwareMonitor::get_cpu_temperature()); });
+    bench.run("HardwareMonitor::get_cpu_name", 0.0, [](uint64_t) { keep(HardwareMonitor::get_cpu_name()); });
+    bench.run("HardwareMonitor::get_gpu_usage", 0.0, [](uint64_t) { keep(HardwareMonitor::get_gpu_usage()); });
+    bench.run("HardwareMonitor::get_gpu_temperature", 0.0, [](uint64_t) { keep(HardwareMonitor::get_gpu_temperature()); });
+    bench.run("HardwareMonitor::get_gpu_name", 0.0, [](uint64_t) { keep(HardwareMonitor::get_gpu_name()); });
+    bench.run("HardwareMonitor::get_network_stats", 0.0, [](uint64_t) { keep(HardwareMonitor::get_network_stats()); });
+    bench.run("HardwareMonitor::get_current_stats", 0.0, [](uint64_t) { keep(HardwareMonitor::get_current_stats()); });
+    {
+        // Steady state of the GUI's sampling loop: one sampler, one reused HardwareStats
+        static HardwareSampler sampler;
+        static HardwareStats stats;
+        bench.run("HardwareSampler::sample", 0.0, [](uint64_t) { sampler.sample(stats); keep(stats); });
+        bench.run("HardwareSampler::sample_cpu", 0.0, [](uint64_t) { sampler.sample_cpu(stats); keep(stats); });
+    }
+    {
+        // Full /proc scan; cost grows with the number of processes on the host
+        static ProcessCollector collector;
+        static std::vector<ProcessStats> top_cpu, top_memory;
+        bench.run("ProcessCollector::sample/top10", 0.0, [](uint64_t) {
+            collector.sample(10, top_cpu, top_memory);
+            keep(top_cpu);
+        });
+    }
+
+    bench.section("Analysis");
+    {
+        // One closed bucket: 20 services x every metric x 11 lags, 1h window at 1 s
+        static CorrelationEngine engine(1, 3600, 10);
+        static HardwareStats stats;
+        static std::vector<std::string> services;
+        for (int i = 0; i < 20; i++) services.push_back("service" + std::to_string(i) + ".service");
+        bench.run("CorrelationEngine::advance/20 services", 0.0, [](uint64_t i) {
+            int64_t now = static_cast<int64_t>(i);
+            stats.cpu_usage = static_cast<double>(i % 97);
+            engine.add_sample(now, stats);
+            engine.add_errors(now, services[i % services.size()], static_cast<uint32_t>(i % 5));
+            engine.advance(now + 1);
+        });
+    }
+
+    if (!compare_path.empty()) {
+        print_comparison(read_json(compare_path), bench.results());
+    }
+    if (!json_path.empty()) {
+        write_json(json_path, bench.results());
+        std::printf("\nResults written to %s\n", json_path.c_str());
+    }
+    return 0;
+}
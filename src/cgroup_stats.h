@@ -0,0 +1,362 @@
+#ifndef CGROUP_STATS_H
+#define CGROUP_STATS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include "proc_reader.h"
+
+// One resource's pressure stall information (PSI); percentages of wall time
+struct PressureStats {
+    double some_avg10 = 0.0;  // At least one runnable task was stalled on the resource
+    double some_avg60 = 0.0;
+    double full_avg10 = 0.0;  // Every non-idle task was stalled at once
+    double full_avg60 = 0.0;
+    double some_rate = 0.0;   // Since the previous sample, from the stall time totals
+    double full_rate = 0.0;
+};
+
+struct SystemPressure {
+    bool available = false;  // Needs CONFIG_PSI and no psi=0 on the kernel command line
+    PressureStats cpu;
+    PressureStats memory;
+    PressureStats io;
+};
+
+struct UnitResourceStats {
+    std::string unit;             // "sshd.service", as journalctl -u takes it
+    double cpu_percent = 0.0;     // Of one CPU since the previous sample, like top
+    uint64_t memory_bytes = 0;    // memory.current, page cache included
+    double read_bytes_per_sec = 0.0;
+    double write_bytes_per_sec = 0.0;
+    double io_per_sec = 0.0;      // Read and write operations
+};
+
+// Host-wide pressure from /proc/pressure/{cpu,memory,io}
+class PressureCollector {
+public:
+    PressureCollector() : cpu_("/proc/pressure/cpu"), memory_("/proc/pressure/memory"), io_("/proc/pressure/io") {}
+
+    bool sample(SystemPressure& pressure, char* buf, size_t capacity) {
+        uint64_t now = MonotonicClock::now_ns();
+        double elapsed_us = previous_ns_ ? (now - previous_ns_) / 1e3 : 0.0;
+        previous_ns_ = now;
+        bool ok = read(cpu_, pressure.cpu, totals_[0], elapsed_us, buf, capacity);
+        ok = read(memory_, pressure.memory, totals_[1], elapsed_us, buf, capacity) && ok;
+        ok = read(io_, pressure.io, totals_[2], elapsed_us, buf, capacity) && ok;
+        pressure.available = ok;
+        return ok;
+    }
+
+private:
+    struct Totals {
+        uint64_t some = 0, full = 0; // µs stalled since boot
+    };
+
+    // "some avg10=0.58 avg60=1.84 avg300=1.72 total=57574606"; the cpu file
+    // has no "full" line before Linux 5.13
+    static bool read(const ProcFile& file, PressureStats& stats, Totals& totals, double elapsed_us, char* buf,
+                     size_t capacity) {
+        long length = file.read(buf, capacity);
+        if (length <= 0) return false;
+        const char* end = buf + length;
+        Totals current;
+        parse_line(ProcScan::find_line(buf, end, "some "), end, stats.some_avg10, stats.some_avg60, current.some);
+        parse_line(ProcScan::find_line(buf, end, "full "), end, stats.full_avg10, stats.full_avg60, current.full);
+        stats.some_rate = rate(current.some, totals.some, elapsed_us);
+        stats.full_rate = rate(current.full, totals.full, elapsed_us);
+        totals = current;
+        return true;
+    }
+
+    static void parse_line(const char* p, const char* end, double& avg10, double& avg60, uint64_t& total) {
+        avg10 = avg60 = 0.0;
+        total = 0;
+        if (!p) return;
+        const char* line_end = ProcScan::next_line(p, end);
+        avg10 = parse_field(p, line_end, "avg10=");
+        avg60 = parse_field(p, line_end, "avg60=");
+        const char* value = find_field(p, line_end, "total=");
+        if (value) ProcScan::parse_u64(value, line_end, total);
+    }
+
+    static const char* find_field(const char* p, const char* end, const char* key) {
+        size_t key_length = std::strlen(key);
+        for (p = ProcScan::skip_spaces(p, end); p < end; p = ProcScan::skip_spaces(ProcScan::skip_token(p, end), end)) {
+            if (static_cast<size_t>(end - p) >= key_length && std::memcmp(p, key, key_length) == 0) return p + key_length;
+        }
+        return nullptr;
+    }
+
+    // "1.84": two decimals, no sign or exponent
+    static double parse_field(const char* p, const char* end, const char* key) {
+        const char* value = find_field(p, end, key);
+        uint64_t whole = 0, fraction = 0;
+        if (!value || !(value = ProcScan::parse_u64(value, end, whole))) return 0.0;
+        double scale = 1.0;
+        if (value < end && *value == '.') {
+            const char* digits = value + 1;
+            const char* digits_end = ProcScan::parse_u64(digits, end, fraction);
+            if (digits_end) {
+                for (const char* d = digits; d < digits_end; d++) scale *= 10.0;
+            }
+        }
+        return whole + fraction / scale;
+    }
+
+    static double rate(uint64_t current, uint64_t previous, double elapsed_us) {
+        if (elapsed_us <= 0.0 || current < previous) return 0.0;
+        return std::min(100.0, (current - previous) * 100.0 / elapsed_us);
+    }
+
+    ProcFile cpu_;
+    ProcFile memory_;
+    ProcFile io_;
+    uint64_t previous_ns_ = 0;
+    Totals totals_[3];
+};
+
+// CPU, memory and block I/O of every service in system.slice, read from the
+// cgroup v2 cpu.stat, memory.current and io.stat of each unit, with rates as
+// deltas between samples. Template instances one slice down (e.g.
+// system-getty.slice/getty@tty1.service) are included. The directories are
+// listed once and again only when inotify reports a unit cgroup created or
+// removed, so a steady-state sample is three preads per unit.
+class UnitCollector {
+public:
+    explicit UnitCollector(std::string slice = default_slice()) : slice_(std::move(slice)) {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+
+    ~UnitCollector() {
+        if (inotify_fd_ >= 0) close(inotify_fd_);
+    }
+
+    UnitCollector(const UnitCollector&) = delete;
+    UnitCollector& operator=(const UnitCollector&) = delete;
+
+    // system.slice of the cgroup v2 hierarchy, whether mounted on its own
+    // (unified) or beside the v1 controllers (hybrid)
+    static std::string default_slice() {
+        struct stat st;
+        if (stat("/sys/fs/cgroup/cgroup.controllers", &st) == 0) return "/sys/fs/cgroup/system.slice";
+        return "/sys/fs/cgroup/unified/system.slice";
+    }
+
+    // The unit journalctl -u resolves a bare name to: "sshd" -> "sshd.service"
+    static std::string unit_name(const std::string& service) {
+        static const char* suffixes[] = {".service", ".scope", ".socket", ".timer", ".mount", ".slice", ".target"};
+        for (const char* suffix : suffixes) {
+            size_t length = std::strlen(suffix);
+            if (service.size() > length && service.compare(service.size() - length, length, suffix) == 0) {
+                return service;
+            }
+        }
+        return service + ".service";
+    }
+
+    // The unit get_service_logs(service) reads logs for, if it has a cgroup
+    static const UnitResourceStats* find(const std::vector<UnitResourceStats>& units, const std::string& service) {
+        std::string name = unit_name(service);
+        for (const auto& unit : units) {
+            if (unit.unit == name) return &unit;
+        }
+        return nullptr;
+    }
+
+    // Fills units in name order, reusing existing elements. The first sample
+    // of a unit reports zero rates.
+    bool sample(std::vector<UnitResourceStats>& units, char* buf, size_t capacity) {
+        if (!listed_ || directories_changed()) {
+            if (!relist()) {
+                units.clear();
+                return false;
+            }
+        }
+
+        uint64_t now = MonotonicClock::now_ns();
+        double elapsed = previous_ns_ ? (now - previous_ns_) / 1e9 : 0.0;
+        previous_ns_ = now;
+
+        units.resize(units_.size());
+        for (size_t i = 0; i < units_.size(); i++) {
+            Unit& unit = *units_[i];
+            UnitResourceStats& stats = units[i];
+            stats.unit = unit.name;
+
+            Counters current;
+            bool ok = read_cpu(unit, current, buf, capacity);
+            read_io(unit, current, buf, capacity);
+            uint64_t memory = 0;
+            long length = unit.memory.read(buf, capacity);
+            if (length > 0) ProcScan::parse_u64(buf, buf + length, memory);
+            stats.memory_bytes = memory;
+
+            // A unit restarted since the last listing has fresh, smaller counters
+            bool comparable = ok && unit.primed && elapsed > 0.0 && current.cpu_usec >= unit.counters.cpu_usec &&
+                              current.read_bytes >= unit.counters.read_bytes &&
+                              current.write_bytes >= unit.counters.write_bytes && current.ios >= unit.counters.ios;
+            if (comparable) {
+                stats.cpu_percent = (current.cpu_usec - unit.counters.cpu_usec) / (elapsed * 1e4);
+                stats.read_bytes_per_sec = (current.read_bytes - unit.counters.read_bytes) / elapsed;
+                stats.write_bytes_per_sec = (current.write_bytes - unit.counters.write_bytes) / elapsed;
+                stats.io_per_sec = (current.ios - unit.counters.ios) / elapsed;
+            } else {
+                stats.cpu_percent = stats.read_bytes_per_sec = stats.write_bytes_per_sec = stats.io_per_sec = 0.0;
+            }
+            unit.counters = current;
+            unit.primed = ok;
+        }
+        return true;
+    }
+
+private:
+    struct Counters {
+        uint64_t cpu_usec = 0;
+        uint64_t read_bytes = 0;
+        uint64_t write_bytes = 0;
+        uint64_t ios = 0;
+    };
+
+    // ProcFile is not movable, so units live behind pointers
+    struct Unit {
+        std::string name;
+        std::string path;
+        ProcFile cpu;
+        ProcFile memory;
+        ProcFile io;
+        Counters counters;
+        bool primed = false;
+    };
+
+    static bool ends_with(const char* name, const char* suffix) {
+        size_t length = std::strlen(name), suffix_length = std::strlen(suffix);
+        return length > suffix_length && std::memcmp(name + length - suffix_length, suffix, suffix_length) == 0;
+    }
+
+    // Drains pending events; any unit or slice created, removed or renamed
+    // means a new listing. Without inotify every sample lists again.
+    bool directories_changed() {
+        if (inotify_fd_ < 0) return true;
+        bool changed = false;
+        alignas(struct inotify_event) char events[4096];
+        while (true) {
+            ssize_t n = read(inotify_fd_, events, sizeof(events));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            changed = true;
+        }
+        return changed;
+    }
+
+    void watch(const std::string& directory) {
+        if (inotify_fd_ >= 0) {
+            inotify_add_watch(inotify_fd_, directory.c_str(),
+                              IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+        }
+    }
+
+    bool relist() {
+        std::vector<std::pair<std::string, std::string>> found; // Name, cgroup directory
+        if (!list(slice_, found, true)) {
+            units_.clear();
+            listed_ = false;
+            return false;
+        }
+        std::sort(found.begin(), found.end());
+
+        // Keep the counters of units still there; files are reopened because
+        // a unit restarted between listings has a new cgroup under the same name
+        std::vector<std::unique_ptr<Unit>> units;
+        units.reserve(found.size());
+        size_t cursor = 0;
+        for (auto& entry : found) {
+            while (cursor < units_.size() && units_[cursor]->name < entry.first) cursor++;
+            std::unique_ptr<Unit> unit;
+            if (cursor < units_.size() && units_[cursor]->name == entry.first) {
+                unit = std::move(units_[cursor++]);
+            } else {
+                unit.reset(new Unit);
+                unit->name = entry.first;
+            }
+            unit->path = std::move(entry.second);
+            unit->cpu.open((unit->path + "/cpu.stat").c_str());
+            unit->memory.open((unit->path + "/memory.current").c_str());
+            unit->io.open((unit->path + "/io.stat").c_str());
+            units.push_back(std::move(unit));
+        }
+        units_.swap(units);
+        listed_ = true;
+        return true;
+    }
+
+    // Units directly in directory and, from the top slice, one level of sub-slices
+    bool list(const std::string& directory, std::vector<std::pair<std::string, std::string>>& found, bool top) {
+        DIR* dir = opendir(directory.c_str());
+        if (!dir) return false;
+        watch(directory);
+        std::vector<std::string> slices;
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) continue;
+            if (ends_with(entry->d_name, ".service")) {
+                found.emplace_back(entry->d_name, directory + "/" + entry->d_name);
+            } else if (top && ends_with(entry->d_name, ".slice")) {
+                slices.push_back(directory + "/" + entry->d_name);
+            }
+        }
+        closedir(dir);
+        for (const auto& slice : slices) list(slice, found, false);
+        return true;
+    }
+
+    // "usage_usec 123\nuser_usec 100\nsystem_usec 23\n..."
+    static bool read_cpu(const Unit& unit, Counters& counters, char* buf, size_t capacity) {
+        long length = unit.cpu.read(buf, capacity);
+        if (length <= 0) return false;
+        const char* p = ProcScan::find_line(buf, buf + length, "usage_usec ");
+        return p && ProcScan::parse_u64(p, buf + length, counters.cpu_usec);
+    }
+
+    // "8:0 rbytes=1459200 wbytes=314773504 rios=192 wios=353 dbytes=0 dios=0"
+    // per device, summed; empty without the io controller
+    static void read_io(const Unit& unit, Counters& counters, char* buf, size_t capacity) {
+        long length = unit.io.read(buf, capacity);
+        if (length <= 0) return;
+        const char* end = buf + length;
+        for (const char* line = buf; line < end; line = ProcScan::next_line(line, end)) {
+            const char* line_end = ProcScan::next_line(line, end);
+            for (const char* p = ProcScan::skip_token(line, line_end); p < line_end;) {
+                p = ProcScan::skip_spaces(p, line_end);
+                const char* equals = p;
+                while (equals < line_end && *equals != '=' && *equals != ' ') equals++;
+                if (equals == line_end || *equals != '=') break;
+                uint64_t value = 0;
+                const char* next = ProcScan::parse_u64(equals + 1, line_end, value);
+                if (!next) break;
+                size_t key_length = static_cast<size_t>(equals - p);
+                if (key_length == 6 && std::memcmp(p, "rbytes", 6) == 0) counters.read_bytes += value;
+                else if (key_length == 6 && std::memcmp(p, "wbytes", 6) == 0) counters.write_bytes += value;
+                else if (key_length == 4 && (std::memcmp(p, "rios", 4) == 0 || std::memcmp(p, "wios", 4) == 0)) counters.ios += value;
+                p = next;
+            }
+        }
+    }
+
+    std::string slice_;
+    int inotify_fd_ = -1;
+    bool listed_ = false;
+    uint64_t previous_ns_ = 0;
+    std::vector<std::unique_ptr<Unit>> units_; // Sorted by name
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef COLLECTOR_SCHEDULER_H
+#define COLLECTOR_SCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "error_handler.h"
+#include "profiler.h"
+
+// Runs collectors at their own rates from one thread. Each collector declares
+// a period and a time budget; due collectors are kept in a deadline-ordered
+// min-heap and the thread sleeps until the earliest deadline, running every
+// collector due within COALESCE_MS of it in the same wakeup. A collector
+// that overruns its budget has its period doubled (up to MAX_BACKOFF times
+// the declared one) and earns it back by running in under half its budget.
+class CollectorScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int COALESCE_MS = 50;
+    static constexpr unsigned MAX_BACKOFF = 16;
+
+    struct CollectorInfo {
+        std::string name;
+        std::chrono::milliseconds period;  // Declared period; zero runs once
+        std::chrono::microseconds budget;
+        unsigned backoff = 1;               // Current period is period * backoff
+        uint64_t runs = 0;
+        uint64_t last_ns = 0;               // Duration of the latest run
+    };
+
+    CollectorScheduler() = default;
+    CollectorScheduler(const CollectorScheduler&) = delete;
+    CollectorScheduler& operator=(const CollectorScheduler&) = delete;
+
+    // Call before run(). name must be a string literal: it also labels --trace-out spans
+    void add(const char* name, std::chrono::milliseconds period, std::chrono::microseconds budget, std::function<void()> fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        collectors_.push_back({name, std::move(fn), {name, period, budget}, false});
+        push(Clock::now(), collectors_.size() - 1);
+    }
+
+    // Runs until stop(). after_batch(ns) is called once per wakeup, after the
+    // due collectors ran, with the time they took together.
+    template <typename Fn>
+    void run(Fn after_batch) {
+        std::vector<size_t> batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            if (heap_.empty()) {
+                wakeup_.wait(lock, [this] { return !running_ || !heap_.empty(); });
+                continue;
+            }
+            Clock::time_point now = Clock::now();
+            if (heap_.front().deadline > now) {
+                wakeup_.wait_until(lock, heap_.front().deadline);
+                continue;
+            }
+
+            batch.clear();
+            Clock::time_point horizon = now + std::chrono::milliseconds(COALESCE_MS);
+            while (!heap_.empty() && heap_.front().deadline <= horizon) {
+                std::pop_heap(heap_.begin(), heap_.end(), later);
+                batch.push_back(heap_.back().index);
+                scheduled_.push_back(heap_.back().deadline);
+                heap_.pop_back();
+            }
+            lock.unlock();
+
+            uint64_t batch_start = Tracer::now_ns();
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::HARDWARE);
+                for (size_t index : batch) {
+                    Collector& collector = collectors_[index];
+                    uint64_t start = Tracer::now_ns();
+                    collector.fn();
+                    uint64_t end = Tracer::now_ns();
+                    Tracer::complete(collector.trace_name, "hardware", start, end);
+                    adapt(collector, end - start);
+                }
+            }
+            after_batch(Tracer::now_ns() - batch_start);
+
+            lock.lock();
+            now = Clock::now();
+            for (size_t i = 0; i < batch.size(); i++) {
+                const CollectorInfo& info = collectors_[batch[i]].info;
+                if (info.period.count() == 0) continue;
+                // Keep the cadence; after an overrun skip the missed ticks instead of bursting
+                Clock::time_point next = scheduled_[i] + info.period * info.backoff;
+                push(next > now ? next : now + info.period * info.backoff, batch[i]);
+            }
+            scheduled_.clear();
+        }
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        wakeup_.notify_all();
+    }
+
+    // Snapshot of each collector's schedule, in add() order
+    std::vector<CollectorInfo> collectors() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<CollectorInfo> infos;
+        for (const auto& collector : collectors_) infos.push_back(collector.info);
+        return infos;
+    }
+
+private:
+    struct Collector {
+        const char* trace_name;
+        std::function<void()> fn;
+        CollectorInfo info;
+        bool reported; // Backoff is logged once per collector
+    };
+
+    struct Deadline {
+        Clock::time_point deadline;
+        size_t index;
+    };
+
+    // Orders the heap so the earliest deadline is at the front
+    static bool later(const Deadline& a, const Deadline& b) { return a.deadline > b.deadline; }
+
+    void push(Clock::time_point deadline, size_t index) {
+        heap_.push_back({deadline, index});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+        wakeup_.notify_all();
+    }
+
+    void adapt(Collector& collector, uint64_t ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CollectorInfo& info = collector.info;
+        info.runs++;
+        info.last_ns = ns;
+        uint64_t budget_ns = static_cast<uint64_t>(info.budget.count()) * 1000;
+        if (ns > budget_ns && info.backoff < MAX_BACKOFF) {
+            if (!collector.reported) {
+                collector.reported = true;
+                ErrorHandler::log_error("Collector " + info.name + " took " + std::to_string(ns / 1000) +
+                                        "us (budget " + std::to_string(info.budget.count()) + "us), backing off",
+                                        ErrorLevel::INFO);
+            }
+            info.backoff *= 2;
+        } else if (ns * 2 <= budget_ns && info.backoff > 1) {
+            info.backoff /= 2;
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::vector<Collector> collectors_;
+    std::vector<Deadline> heap_;
+    std::vector<Clock::time_point> scheduled_;
+    bool running_ = true;
+};
+
+#endif
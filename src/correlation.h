@@ -0,0 +1,349 @@
+#ifndef CORRELATION_H
+#define CORRELATION_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "stats_history.h"
+
+// How strongly a service's error count follows a hardware figure
+struct Correlation {
+    std::string service;
+    HistoryMetric metric = HistoryMetric::CPU;
+    int lag_seconds = 0;  // The hardware figure leads the errors by this much
+    double r = 0.0;       // Pearson coefficient at that lag
+    size_t points = 0;
+};
+
+// An error spike with a hardware spike at or shortly before it
+struct CoAnomaly {
+    int64_t time = 0;     // Start of the error bucket
+    std::string service;
+    uint32_t errors = 0;
+    HistoryMetric metric = HistoryMetric::CPU;
+    int lag_seconds = 0;
+    double value = 0.0;   // The hardware bucket's average
+    double z = 0.0;       // Its deviation from the recent norm
+};
+
+// Aligns per-service error counts with hardware samples on one time axis of
+// fixed buckets and keeps, for every service, metric and lag, the running
+// sums behind a Pearson coefficient over the last window buckets. Closing a
+// bucket adds its terms and retires those that left the window, so the cost
+// per bucket is services x metrics x lags whatever the window, and the
+// engine can be fed continuously. Both series also keep an exponentially
+// weighted mean and variance; a bucket more than ANOMALY_Z deviations above
+// it is a spike, and an error spike with a hardware spike up to max_lag
+// buckets earlier is reported as a co-anomaly.
+//
+// Data may arrive for the open bucket and up to OPEN_BUCKETS - 1 after it;
+// advance() closes buckets once no more data is expected for them, and later
+// data for them is dropped.
+class CorrelationEngine {
+public:
+    static constexpr int METRIC_COUNT = StatsHistory::METRIC_COUNT;
+    static constexpr size_t MAX_SERVICES = 64;        // Beyond this, services share "other"
+    static constexpr int64_t OPEN_BUCKETS = 4;
+    static constexpr size_t MIN_POINTS = 10;          // Fewer pairs give no coefficient
+    static constexpr double ANOMALY_Z = 3.0;
+    static constexpr double ANOMALY_SPAN = 30.0;      // Buckets the norm mostly reflects
+    static constexpr uint64_t ANOMALY_WARMUP = 10;    // Buckets before a series can spike
+    static constexpr uint32_t MIN_ERROR_SPIKE = 3;
+    static constexpr size_t MAX_CO_ANOMALIES = 200;
+
+    CorrelationEngine(int resolution, size_t window, int max_lag)
+        : resolution_(std::max(1, resolution)), window_(std::max<size_t>(window, 1)), max_lag_(std::max(0, max_lag)),
+          capacity_(window_ + static_cast<size_t>(max_lag_) + OPEN_BUCKETS) {
+        for (auto& series : metrics_) {
+            series.sums.assign(capacity_, 0.0);
+            series.counts.assign(capacity_, 0);
+            series.spikes.assign(capacity_, 0.0);
+        }
+    }
+
+    int resolution() const { return resolution_; }
+
+    void add_metric(int64_t time, HistoryMetric metric, double value) {
+        int index = static_cast<int>(metric);
+        if (index < 0 || index >= METRIC_COUNT) return;
+        int64_t bucket = accept(time);
+        if (bucket < 0) return;
+        size_t slot = slot_of(bucket);
+        metrics_[index].sums[slot] += value;
+        metrics_[index].counts[slot]++;
+    }
+
+    void add_sample(int64_t time, const HardwareStats& stats) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            HistoryMetric metric = static_cast<HistoryMetric>(m);
+            add_metric(time, metric, StatsHistory::value_of(metric, stats));
+        }
+    }
+
+    void add_errors(int64_t time, const std::string& service, uint32_t count = 1) {
+        int64_t bucket = accept(time);
+        if (bucket < 0) return;
+        find_service(service).errors[slot_of(bucket)] += count;
+    }
+
+    // Closes every bucket that ends at or before now
+    void advance(int64_t now) {
+        if (next_ == UNSTARTED) return;
+        int64_t end = floor_div(now, resolution_);
+        while (next_ < end) close(next_++);
+    }
+
+    // The lag with the strongest positive coefficient for each service and
+    // metric pair, strongest first
+    std::vector<Correlation> correlations(double min_r = 0.0) const {
+        std::vector<Correlation> results;
+        for (const auto& service : services_) {
+            for (int m = 0; m < METRIC_COUNT; m++) {
+                Correlation best;
+                best.r = -std::numeric_limits<double>::infinity();
+                for (int lag = 0; lag <= max_lag_; lag++) {
+                    const Sums& sums = service->sums[m * (max_lag_ + 1) + lag];
+                    double r = sums.pearson();
+                    if (sums.n >= MIN_POINTS && !std::isnan(r) && r > best.r) {
+                        best.r = r;
+                        best.lag_seconds = lag * resolution_;
+                        best.points = sums.n;
+                    }
+                }
+                if (best.points == 0 || best.r < min_r) continue;
+                best.service = service->name;
+                best.metric = static_cast<HistoryMetric>(m);
+                results.push_back(best);
+            }
+        }
+        std::sort(results.begin(), results.end(), [](const Correlation& a, const Correlation& b) { return a.r > b.r; });
+        return results;
+    }
+
+    // Most recent last
+    const std::deque<CoAnomaly>& co_anomalies() const { return co_anomalies_; }
+
+private:
+    static constexpr int64_t UNSTARTED = std::numeric_limits<int64_t>::min();
+
+    // Running sums for one (hardware figure, error count) pairing
+    struct Sums {
+        size_t n = 0;
+        double x = 0.0, y = 0.0, xx = 0.0, yy = 0.0, xy = 0.0;
+
+        void add(double a, double b, double sign) {
+            n = sign > 0 ? n + 1 : n - 1;
+            x += sign * a;
+            y += sign * b;
+            xx += sign * a * a;
+            yy += sign * b * b;
+            xy += sign * a * b;
+        }
+
+        // NaN when either side is flat
+        double pearson() const {
+            double count = static_cast<double>(n);
+            double vx = count * xx - x * x;
+            double vy = count * yy - y * y;
+            if (n < 2 || vx <= 1e-9 * count * count || vy <= 1e-9 * count * count) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            return std::clamp((count * xy - x * y) / std::sqrt(vx * vy), -1.0, 1.0);
+        }
+    };
+
+    // Exponentially weighted norm of one series
+    struct Norm {
+        double mean = 0.0;
+        double variance = 0.0;
+        uint64_t seen = 0;
+
+        // Deviations above the norm before folding value in, measured against
+        // at least floor so a flat series does not turn noise into spikes
+        double update(double value, double floor) {
+            double deviation = std::max(std::sqrt(variance), floor);
+            double z = seen >= ANOMALY_WARMUP ? (value - mean) / deviation : 0.0;
+            double alpha = 2.0 / (ANOMALY_SPAN + 1.0);
+            double delta = value - mean;
+            mean += alpha * delta;
+            variance = (1.0 - alpha) * (variance + alpha * delta * delta);
+            seen++;
+            return z;
+        }
+    };
+
+    struct MetricSeries {
+        std::vector<double> sums;      // Per bucket; the value is sums / counts
+        std::vector<uint32_t> counts;  // Samples in the bucket; none means no value
+        std::vector<double> spikes;    // z of closed buckets that spiked, else 0
+        Norm norm;
+    };
+
+    struct ServiceSeries {
+        std::string name;
+        std::vector<uint32_t> errors;
+        std::vector<Sums> sums;        // METRIC_COUNT x (max_lag + 1)
+        Norm norm;
+    };
+
+    static int64_t floor_div(int64_t value, int64_t divisor) {
+        int64_t quotient = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+    }
+
+    size_t slot_of(int64_t bucket) const {
+        int64_t slot = bucket % static_cast<int64_t>(capacity_);
+        return static_cast<size_t>(slot < 0 ? slot + static_cast<int64_t>(capacity_) : slot);
+    }
+
+    // The bucket for time, or -1 when it is closed or too far ahead
+    int64_t accept(int64_t time) {
+        int64_t bucket = floor_div(time, resolution_);
+        if (next_ == UNSTARTED) first_ = next_ = bucket;
+        if (bucket < next_ || bucket >= next_ + OPEN_BUCKETS) return -1;
+        return bucket;
+    }
+
+    bool valid(int m, int64_t bucket) const { return bucket >= first_ && metrics_[m].counts[slot_of(bucket)] > 0; }
+
+    double value(int m, int64_t bucket) const {
+        size_t slot = slot_of(bucket);
+        return metrics_[m].sums[slot] / metrics_[m].counts[slot];
+    }
+
+    // Spikes are judged against a floor per figure: a couple of percent or
+    // degrees, half a load point, 64 KB/s of I/O
+    static double noise_floor(HistoryMetric metric) {
+        switch (metric) {
+            case HistoryMetric::LOAD: return 0.5;
+            case HistoryMetric::DISK_READ:
+            case HistoryMetric::DISK_WRITE:
+            case HistoryMetric::NETWORK_RX:
+            case HistoryMetric::NETWORK_TX: return 64.0;
+            case HistoryMetric::CONNECTIONS: return 5.0;
+            default: return 2.0;
+        }
+    }
+
+    ServiceSeries& find_service(const std::string& name) {
+        for (auto& service : services_) {
+            if (service->name == name) return *service;
+        }
+        if (services_.size() >= MAX_SERVICES) {
+            for (auto& service : services_) {
+                if (service->name == "other") return *service;
+            }
+            return add_service("other");
+        }
+        return add_service(name);
+    }
+
+    // A service seen for the first time had no errors in the closed buckets,
+    // so its sums start from those buckets paired with zero, and its norm is
+    // already warm: a first burst can be a spike
+    ServiceSeries& add_service(const std::string& name) {
+        std::unique_ptr<ServiceSeries> service(new ServiceSeries);
+        service->name = name;
+        service->errors.assign(capacity_, 0);
+        service->norm.seen = closed_;
+        service->sums.resize(static_cast<size_t>(METRIC_COUNT) * (max_lag_ + 1));
+        rebuild(*service);
+        services_.push_back(std::move(service));
+        return *services_.back();
+    }
+
+    // Recomputes a service's sums from the stored buckets
+    void rebuild(ServiceSeries& service) const {
+        std::fill(service.sums.begin(), service.sums.end(), Sums());
+        int64_t oldest = std::max(first_, next_ - static_cast<int64_t>(window_));
+        for (int64_t bucket = oldest; bucket < next_; bucket++) pair(service, bucket, 1.0);
+    }
+
+    void pair(ServiceSeries& service, int64_t bucket, double sign) const {
+        double errors = service.errors[slot_of(bucket)];
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            for (int lag = 0; lag <= max_lag_; lag++) {
+                if (valid(m, bucket - lag)) {
+                    service.sums[m * (max_lag_ + 1) + lag].add(value(m, bucket - lag), errors, sign);
+                }
+            }
+        }
+    }
+
+    void close(int64_t bucket) {
+        int64_t retired = bucket - static_cast<int64_t>(window_);
+        for (auto& service : services_) {
+            if (retired >= first_) pair(*service, retired, -1.0);
+            pair(*service, bucket, 1.0);
+        }
+
+        size_t slot = slot_of(bucket);
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            MetricSeries& series = metrics_[m];
+            series.spikes[slot] = 0.0;
+            if (series.counts[slot] == 0) continue;
+            double z = series.norm.update(value(m, bucket), noise_floor(static_cast<HistoryMetric>(m)));
+            if (z >= ANOMALY_Z) series.spikes[slot] = z;
+        }
+        for (auto& service : services_) {
+            uint32_t errors = service->errors[slot];
+            double z = service->norm.update(errors, 1.0);
+            if (errors >= MIN_ERROR_SPIKE && z >= ANOMALY_Z) report(*service, bucket, errors);
+        }
+
+        // Sums drift as terms are added and retired; refresh them once per window
+        if (++closed_ % window_ == 0) {
+            for (auto& service : services_) rebuild(*service);
+        }
+
+        // The slot reused by the newest open bucket held data no pair needs any more
+        size_t reused = slot_of(bucket + OPEN_BUCKETS);
+        for (auto& series : metrics_) {
+            series.sums[reused] = 0.0;
+            series.counts[reused] = 0;
+            series.spikes[reused] = 0.0;
+        }
+        for (auto& service : services_) service->errors[reused] = 0;
+    }
+
+    // One co-anomaly per metric that spiked, at the shortest lag
+    void report(const ServiceSeries& service, int64_t bucket, uint32_t errors) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            for (int lag = 0; lag <= max_lag_; lag++) {
+                int64_t when = bucket - lag;
+                if (when < first_) break;
+                double z = metrics_[m].spikes[slot_of(when)];
+                if (z < ANOMALY_Z) continue;
+                CoAnomaly anomaly;
+                anomaly.time = bucket * resolution_;
+                anomaly.service = service.name;
+                anomaly.errors = errors;
+                anomaly.metric = static_cast<HistoryMetric>(m);
+                anomaly.lag_seconds = lag * resolution_;
+                anomaly.value = value(m, when);
+                anomaly.z = z;
+                co_anomalies_.push_back(anomaly);
+                if (co_anomalies_.size() > MAX_CO_ANOMALIES) co_anomalies_.pop_front();
+                break;
+            }
+        }
+    }
+
+    int resolution_;
+    size_t window_;
+    int max_lag_;
+    size_t capacity_;
+    int64_t first_ = UNSTARTED;  // First bucket that received data
+    int64_t next_ = UNSTARTED;   // First open bucket
+    uint64_t closed_ = 0;
+    MetricSeries metrics_[METRIC_COUNT];
+    std::vector<std::unique_ptr<ServiceSeries>> services_;
+    std::deque<CoAnomaly> co_anomalies_;
+};
+
+#endif
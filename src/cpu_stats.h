@@ -0,0 +1,105 @@
+#ifndef CPU_STATS_H
+#define CPU_STATS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "proc_reader.h"
+
+// Percentages of one CPU (or all of them) over the last sampling interval
+struct CpuCoreStats {
+    int core = -1; // -1 for the aggregate "cpu" line
+    double usage = 0.0;
+    double user = 0.0;   // user + nice
+    double system = 0.0; // system + irq + softirq
+    double iowait = 0.0;
+    double steal = 0.0;
+};
+
+// Aggregate and per-core usage from a single /proc/stat read. Each instance
+// keeps its own previous counters, so concurrent users either share one
+// behind a lock or own separate instances.
+class CpuCollector {
+public:
+    CpuCollector() : stat_("/proc/stat") {}
+
+    bool has_baseline() const { return !previous_.empty(); }
+
+    // Fills total and cores (reusing the vector's storage). The first call
+    // only records a baseline and reports zeros.
+    bool sample(CpuCoreStats& total, std::vector<CpuCoreStats>& cores, char* buf, size_t capacity) {
+        long length = 0;
+        const char* text = stat_.read_all(buf, capacity, length);
+        if (!text || length <= 0) return false;
+
+        const char* end = text + length;
+        size_t count = 0;
+        bool had_baseline = has_baseline();
+        for (const char* line = text; line < end && std::memcmp(line, "cpu", 3) == 0; line = ProcScan::next_line(line, end)) {
+            const char* p = line + 3;
+            int core = -1;
+            if (*p != ' ') {
+                uint64_t id = 0;
+                p = ProcScan::parse_u64(p, end, id);
+                if (!p) break;
+                core = static_cast<int>(id);
+            }
+
+            // user nice system idle iowait irq softirq steal (guest time is already in user)
+            Counters current = {};
+            current.seen = true;
+            for (uint64_t& field : current.fields) {
+                const char* next = ProcScan::parse_u64(p, end, field);
+                if (!next) break; // Older kernels have fewer columns
+                p = next;
+            }
+
+            size_t slot = core < 0 ? 0 : static_cast<size_t>(core) + 1;
+            if (slot >= previous_.size()) previous_.resize(slot + 1);
+            CpuCoreStats& stats = core < 0 ? total : core_at(cores, count++);
+            stats.core = core;
+            compute(stats, previous_[slot], current, had_baseline && previous_[slot].seen);
+            previous_[slot] = current;
+        }
+        cores.resize(count);
+        return true;
+    }
+
+private:
+    struct Counters {
+        uint64_t fields[8];
+        bool seen; // False for cores not present in the previous read
+    };
+
+    enum { USER, NICE, SYSTEM, IDLE, IOWAIT, IRQ, SOFTIRQ, STEAL };
+
+    static CpuCoreStats& core_at(std::vector<CpuCoreStats>& cores, size_t index) {
+        if (index == cores.size()) cores.emplace_back();
+        return cores[index];
+    }
+
+    static void compute(CpuCoreStats& stats, const Counters& previous, const Counters& current, bool has_previous) {
+        uint64_t delta[8];
+        uint64_t total = 0;
+        for (int i = 0; i < 8; i++) {
+            // A core that went offline and came back restarts its counters
+            delta[i] = current.fields[i] >= previous.fields[i] ? current.fields[i] - previous.fields[i] : 0;
+            total += delta[i];
+        }
+        if (!has_previous || total == 0) {
+            stats.usage = stats.user = stats.system = stats.iowait = stats.steal = 0.0;
+            return;
+        }
+        double scale = 100.0 / total;
+        stats.usage = (total - delta[IDLE] - delta[IOWAIT]) * scale;
+        stats.user = (delta[USER] + delta[NICE]) * scale;
+        stats.system = (delta[SYSTEM] + delta[IRQ] + delta[SOFTIRQ]) * scale;
+        stats.iowait = delta[IOWAIT] * scale;
+        stats.steal = delta[STEAL] * scale;
+    }
+
+    ProcFile stat_;
+    std::vector<Counters> previous_; // [0] aggregate, [n + 1] cpuN
+};
+
+#endif
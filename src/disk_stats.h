@@ -0,0 +1,140 @@
+#ifndef DISK_STATS_H
+#define DISK_STATS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include "proc_reader.h"
+
+struct DiskDeviceStats {
+    std::string name;
+    double read_bytes_per_sec = 0.0;
+    double write_bytes_per_sec = 0.0;
+    double read_iops = 0.0;
+    double write_iops = 0.0;
+    double await_ms = 0.0;     // Average time per completed request, queueing included
+    double utilization = 0.0;  // % of the interval with at least one request in flight
+};
+
+// Per-device throughput, IOPS, latency and utilization from /proc/diskstats,
+// computed as deltas between two samples like iostat -x. Only whole disks
+// are reported, so partitions are not counted twice; whether a name is one is
+// decided when it first appears (hotplug included) and remembered until it
+// leaves /proc/diskstats.
+class DiskCollector {
+public:
+    DiskCollector() : diskstats_("/proc/diskstats") {}
+
+    // Fills devices in /proc/diskstats order, reusing existing elements so a
+    // steady-state sample does not allocate. The first sample after a device
+    // appears reports zeros.
+    bool sample(std::vector<DiskDeviceStats>& devices, char* buf, size_t capacity) {
+        long length = 0;
+        const char* text = diskstats_.read_all(buf, capacity, length);
+        if (!text || length <= 0) {
+            devices.clear();
+            return false;
+        }
+
+        uint64_t now = MonotonicClock::now_ns();
+        double elapsed = previous_ns_ ? (now - previous_ns_) / 1e9 : 0.0;
+        previous_ns_ = now;
+
+        const char* end = text + length;
+        size_t count = 0;
+        // "   8       0 sda reads merged sectors ms writes merged sectors ms in_flight io_ms weighted_ms ..."
+        for (const char* line = text; line < end; line = ProcScan::next_line(line, end)) {
+            const char* line_end = ProcScan::next_line(line, end);
+            uint64_t major = 0, minor = 0;
+            const char* p = ProcScan::parse_u64(line, line_end, major);
+            if (p) p = ProcScan::parse_u64(p, line_end, minor);
+            if (!p) continue;
+            const char* name = ProcScan::skip_spaces(p, line_end);
+            const char* name_end = ProcScan::skip_token(name, line_end);
+            if (!whole_disk(name, name_end, now)) continue;
+
+            uint64_t fields[10] = {};
+            p = name_end;
+            for (uint64_t& field : fields) {
+                p = ProcScan::parse_u64(p, line_end, field);
+                if (!p) break;
+            }
+            if (!p) continue;
+
+            Counters current = {fields[0], fields[2], fields[3], fields[4], fields[6], fields[7], fields[9]};
+            if (count == devices.size()) devices.emplace_back();
+            DiskDeviceStats& stats = devices[count];
+            stats.name.assign(name, name_end - name);
+
+            auto* previous = previous_.find(stats.name, count);
+            if (previous && elapsed > 0.0) {
+                compute(stats, previous->value, current, elapsed);
+            } else {
+                stats.read_bytes_per_sec = stats.write_bytes_per_sec = 0.0;
+                stats.read_iops = stats.write_iops = stats.await_ms = stats.utilization = 0.0;
+            }
+            previous_.touch(previous, stats.name, now).value = current;
+            count++;
+        }
+        devices.resize(count);
+
+        // Forget devices that went away
+        previous_.forget_unseen(now);
+        kinds_.forget_unseen(now);
+        return true;
+    }
+
+private:
+    // /proc/diskstats sectors are always 512 bytes, whatever the device's block size
+    static constexpr double SECTOR_BYTES = 512.0;
+
+    struct Counters {
+        uint64_t reads, read_sectors, read_ms;
+        uint64_t writes, write_sectors, write_ms;
+        uint64_t io_ms;
+    };
+
+    // Counters are unsigned long in the kernel and wrap on 32-bit systems
+    static uint64_t delta(uint64_t current, uint64_t previous) {
+        return current >= previous ? current - previous : 0;
+    }
+
+    static void compute(DiskDeviceStats& stats, const Counters& previous, const Counters& current, double elapsed) {
+        uint64_t reads = delta(current.reads, previous.reads);
+        uint64_t writes = delta(current.writes, previous.writes);
+        stats.read_bytes_per_sec = delta(current.read_sectors, previous.read_sectors) * SECTOR_BYTES / elapsed;
+        stats.write_bytes_per_sec = delta(current.write_sectors, previous.write_sectors) * SECTOR_BYTES / elapsed;
+        stats.read_iops = reads / elapsed;
+        stats.write_iops = writes / elapsed;
+        uint64_t ios = reads + writes;
+        uint64_t ms = delta(current.read_ms, previous.read_ms) + delta(current.write_ms, previous.write_ms);
+        stats.await_ms = ios > 0 ? static_cast<double>(ms) / ios : 0.0;
+        stats.utilization = std::min(100.0, delta(current.io_ms, previous.io_ms) / (elapsed * 10.0));
+    }
+
+    // Whole disks are the entries of /sys/block, minus loop and ram devices;
+    // only a name not seen before costs a sysfs lookup
+    bool whole_disk(const char* name, const char* name_end, uint64_t now) {
+        size_t length = static_cast<size_t>(name_end - name);
+        auto* known = kinds_.find(name, length);
+        auto& kind = kinds_.touch(known, name, length, now);
+        if (known) return kind.value;
+        kind.value = false;
+        if (kind.name.compare(0, 4, "loop") == 0 || kind.name.compare(0, 3, "ram") == 0) return false;
+        // sysfs spells a '/' in a device name (cciss/c0d0) as '!'
+        std::string path = "/sys/block/" + kind.name;
+        std::replace(path.begin() + 11, path.end(), '/', '!');
+        kind.value = access(path.c_str(), F_OK) == 0;
+        return kind.value;
+    }
+
+    ProcFile diskstats_;
+    NameTable<bool> kinds_; // Whether each name is a whole disk
+    uint64_t previous_ns_ = 0;
+    NameTable<Counters> previous_;
+};
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef HARDWARE_INVENTORY_H
+#define HARDWARE_INVENTORY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "error_handler.h"
+
+struct GpuDevice {
+    std::string pci_address; // e.g. 0000:03:00.0
+    std::string vendor_id;   // e.g. 0x1002
+    std::string device_id;
+    std::string driver;      // amdgpu, nvidia, i915, ... or empty when unbound
+    std::string name;
+};
+
+// Facts that do not change while the machine is up. Discovered from sysfs
+// and /proc once per process and cached on disk until the next boot.
+struct HardwareInventory {
+    std::string boot_id;
+    std::string cpu_model = "Unknown";
+    int cpu_count = 0;
+    std::vector<GpuDevice> gpus;
+
+    bool has_vendor(const char* vendor_id) const {
+        for (const auto& gpu : gpus) {
+            if (gpu.vendor_id == vendor_id) return true;
+        }
+        return false;
+    }
+
+    bool has_nvidia() const { return has_vendor("0x10de"); }
+
+    std::string gpu_name() const { return gpus.empty() ? "Unknown" : gpus.front().name; }
+};
+
+class InventoryProbe {
+public:
+    static constexpr int CACHE_VERSION = 3;
+
+    // Loaded or discovered on first use, then shared for the life of the process
+    static const HardwareInventory& get() {
+        static HardwareInventory inventory = load_or_discover();
+        return inventory;
+    }
+
+    static HardwareInventory discover() {
+        HardwareInventory inventory;
+        inventory.boot_id = read_first_line("/proc/sys/kernel/random/boot_id");
+        read_cpu(inventory);
+        read_gpus(inventory);
+        return inventory;
+    }
+
+    // $XDG_CACHE_HOME/archlog or ~/.cache/archlog; empty when neither is set
+    static std::string cache_path() {
+        const char* xdg = getenv("XDG_CACHE_HOME");
+        if (xdg && xdg[0] == '/') return std::string(xdg) + "/archlog/hardware_inventory";
+        const char* home = getenv("HOME");
+        if (home && home[0] == '/') return std::string(home) + "/.cache/archlog/hardware_inventory";
+        return "";
+    }
+
+    // Name from the pci.ids database, e.g. "Advanced Micro Devices, Inc. [AMD/ATI] Navi 21".
+    // Empty when the database or the vendor is missing.
+    static std::string lookup_pci_name(const std::string& ids_path, const std::string& vendor_id, const std::string& device_id) {
+        std::ifstream ids(ids_path);
+        if (!ids.is_open()) return "";
+
+        std::string vendor = strip_hex_prefix(vendor_id);
+        std::string device = strip_hex_prefix(device_id);
+        std::string vendor_name, line;
+        while (std::getline(ids, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (vendor_name.empty()) {
+                if (line.size() > 6 && line.compare(0, 4, vendor) == 0 && line[4] == ' ') {
+                    vendor_name = line.substr(6);
+                }
+                continue;
+            }
+            if (line[0] != '\t') break; // Next vendor: device not listed
+            if (line.size() > 7 && line[1] != '\t' && line.compare(1, 4, device) == 0 && line[5] == ' ') {
+                return vendor_name + " " + line.substr(7);
+            }
+        }
+        return vendor_name;
+    }
+
+private:
+    static HardwareInventory load_or_discover() {
+        std::string boot_id = read_first_line("/proc/sys/kernel/random/boot_id");
+        std::string path = cache_path();
+
+        HardwareInventory inventory;
+        if (!path.empty() && !boot_id.empty() && load_cache(path, inventory) && inventory.boot_id == boot_id) {
+            return inventory;
+        }
+
+        inventory = discover();
+        if (!path.empty() && !inventory.boot_id.empty()) save_cache(path, inventory);
+        return inventory;
+    }
+
+    static void read_cpu(HardwareInventory& inventory) {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 9, "processor") == 0) {
+                inventory.cpu_count++;
+            } else if (inventory.cpu_model == "Unknown" && line.compare(0, 10, "model name") == 0) {
+                size_t pos = line.find(':');
+                if (pos != std::string::npos && pos + 2 <= line.size()) inventory.cpu_model = line.substr(pos + 2);
+            }
+        }
+    }
+
+    // Display controllers are PCI class 0x03xxxx
+    static void read_gpus(HardwareInventory& inventory) {
+        static const char* ids_paths[] = {"/usr/share/hwdata/pci.ids", "/usr/share/misc/pci.ids"};
+        for (const auto& address : list_dir("/sys/bus/pci/devices")) {
+            std::string base = "/sys/bus/pci/devices/" + address;
+            std::string device_class = read_first_line(base + "/class");
+            if (device_class.compare(0, 4, "0x03") != 0) continue;
+
+            GpuDevice gpu;
+            gpu.pci_address = address;
+            gpu.vendor_id = read_first_line(base + "/vendor");
+            gpu.device_id = read_first_line(base + "/device");
+            char target[256];
+            ssize_t length = readlink((base + "/driver").c_str(), target, sizeof(target) - 1);
+            if (length > 0) {
+                target[length] = '\0';
+                const char* slash = std::strrchr(target, '/');
+                gpu.driver = slash ? slash + 1 : target;
+            }
+            for (const char* ids_path : ids_paths) {
+                gpu.name = lookup_pci_name(ids_path, gpu.vendor_id, gpu.device_id);
+                if (!gpu.name.empty()) break;
+            }
+            if (gpu.name.empty()) {
+                gpu.name = vendor_short_name(gpu.vendor_id) + " [" + strip_hex_prefix(gpu.vendor_id) + ":" +
+                           strip_hex_prefix(gpu.device_id) + "]";
+            }
+            inventory.gpus.push_back(gpu);
+        }
+    }
+
+    static std::string vendor_short_name(const std::string& vendor_id) {
+        if (vendor_id == "0x1002") return "AMD";
+        if (vendor_id == "0x10de") return "NVIDIA";
+        if (vendor_id == "0x8086") return "Intel";
+        return "GPU";
+    }
+
+    static std::string strip_hex_prefix(const std::string& id) {
+        return id.compare(0, 2, "0x") == 0 ? id.substr(2) : id;
+    }
+
+    static std::string read_first_line(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    static std::vector<std::string> list_dir(const char* path) {
+        std::vector<std::string> entries;
+        DIR* dir = opendir(path);
+        if (!dir) return entries;
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            entries.push_back(entry->d_name);
+        }
+        closedir(dir);
+        std::sort(entries.begin(), entries.end());
+        return entries;
+    }
+
+    // One record per line, fields separated by tabs
+    static std::string clean(const std::string& value) {
+        std::string cleaned = value;
+        std::replace(cleaned.begin(), cleaned.end(), '\t', ' ');
+        std::replace(cleaned.begin(), cleaned.end(), '\n', ' ');
+        return cleaned;
+    }
+
+    static std::vector<std::string> split_tabs(const std::string& line) {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        while (true) {
+            size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab - start));
+            if (tab == std::string::npos) break;
+            start = tab + 1;
+        }
+        return fields;
+    }
+
+    static bool load_cache(const std::string& path, HardwareInventory& inventory) {
+        std::ifstream cache(path);
+        std::string line;
+        if (!std::getline(cache, line) || line != "archlog-inventory\t" + std::to_string(CACHE_VERSION)) return false;
+
+        while (std::getline(cache, line)) {
+            std::vector<std::string> fields = split_tabs(line);
+            const std::string& key = fields[0];
+            if (key == "boot_id" && fields.size() == 2) {
+                inventory.boot_id = fields[1];
+            } else if (key == "cpu_model" && fields.size() == 2) {
+                inventory.cpu_model = fields[1];
+            } else if (key == "cpu_count" && fields.size() == 2) {
+                inventory.cpu_count = std::atoi(fields[1].c_str());
+            } else if (key == "gpu" && fields.size() == 6) {
+                inventory.gpus.push_back({fields[1], fields[2], fields[3], fields[4], fields[5]});
+            } else {
+                return false; // Unknown or damaged record: rediscover
+            }
+        }
+        return true;
+    }
+
+    static void save_cache(const std::string& path, const HardwareInventory& inventory) {
+        size_t slash = path.rfind('/');
+        std::string dir = path.substr(0, slash);
+        mkdir(dir.substr(0, dir.rfind('/')).c_str(), 0700);
+        if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return;
+
+        // Write then rename so a concurrent reader never sees half a file
+        std::string tmp = path + "." + std::to_string(getpid());
+        {
+            std::ofstream cache(tmp, std::ios::trunc);
+            if (!cache.is_open()) return;
+            cache << "archlog-inventory\t" << CACHE_VERSION << "\n";
+            cache << "boot_id\t" << clean(inventory.boot_id) << "\n";
+            cache << "cpu_model\t" << clean(inventory.cpu_model) << "\n";
+            cache << "cpu_count\t" << inventory.cpu_count << "\n";
+            for (const auto& gpu : inventory.gpus) {
+                cache << "gpu\t" << clean(gpu.pci_address) << "\t" << clean(gpu.vendor_id) << "\t" << clean(gpu.device_id)
+                      << "\t" << clean(gpu.driver) << "\t" << clean(gpu.name) << "\n";
+            }
+            if (!cache.good()) {
+                unlink(tmp.c_str());
+                return;
+            }
+        }
+        if (rename(tmp.c_str(), path.c_str()) != 0) {
+            ErrorHandler::handle_file_error(path, "hardware inventory cache write");
+            unlink(tmp.c_str());
+        }
+    }
+};
+
+#endif
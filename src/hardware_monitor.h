@@ -13,48 +13,60 @@
 #include <limits>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <mutex>
+#include <thread>
+#include <chrono>
 #include "error_handler.h"
+#include "metrics.h"
+#include "proc_reader.h"
+#include "network_stats.h"
+#include "cpu_stats.h"
+#include "hardware_inventory.h"
+#include "sensors.h"
+#include "socket_stats.h"
+#include "disk_stats.h"
+#include "mount_stats.h"
+#include "nvidia_smi.h"
+#include "cgroup_stats.h"
 
 struct HardwareStats {
     double cpu_usage = 0.0;
+    CpuCoreStats cpu_total;
+    std::vector<CpuCoreStats> cpu_cores;
     double memory_usage = 0.0;
-    double disk_usage = 0.0;
-    double gpu_usage = 0.0;
+    double disk_usage = 0.0; // Of the filesystem mounted on /
+    std::vector<MountUsage> mounts;
+    double disk_read = 0.0;  // KB/s summed over whole disks
+    double disk_write = 0.0;
+    double disk_busy = 0.0;  // Utilization % of the busiest disk
+    std::vector<DiskDeviceStats> disk_devices;
+    double gpu_usage = 0.0;  // Busiest GPU when there are several NVIDIA ones
+    std::vector<NvidiaGpuStats> nvidia_gpus; // Only filled by the nvidia-smi fallback
     std::string system_load = "0.0";
+    SystemPressure pressure;
+    std::vector<UnitResourceStats> units; // system.slice services; only filled by sample_units
     int active_connections = 0;
     int cpu_temp = 0;
     int gpu_temp = 0;
-    double network_rx = 0.0;
+    std::vector<TemperatureReading> temperatures;
+    double network_rx = 0.0; // KB/s summed over non-loopback interfaces
     double network_tx = 0.0;
+    std::vector<NetworkInterfaceStats> network_interfaces;
     std::string gpu_name = "Unknown";
     std::string cpu_name = "Unknown";
 };
 
 class HardwareMonitor {
 public:
-    static HardwareStats get_current_stats() {
-        HardwareStats stats;
-        stats.cpu_usage = get_cpu_usage();
-        stats.memory_usage = get_memory_usage();
-        stats.disk_usage = get_disk_usage();
-        stats.gpu_usage = get_gpu_usage();
-        stats.cpu_temp = get_cpu_temperature();
-        stats.gpu_temp = get_gpu_temperature();
-        stats.system_load = get_system_load();
-        stats.active_connections = get_active_connections();
-        auto network = get_network_stats();
-        stats.network_rx = network.first;
-        stats.network_tx = network.second;
-        stats.gpu_name = get_gpu_name();
-        stats.cpu_name = get_cpu_name();
-        return stats;
-    }
+    // Samples through a shared HardwareSampler; see below
+    static HardwareStats get_current_stats();
+    static void get_current_stats(HardwareStats& stats);
 
-private:
     static double get_gpu_usage() {
         try {
             // Try reading AMD GPU usage directly (more secure)
-            std::ifstream amd_gpu("/sys/class/drm/card0/device/gpu_busy_percent");
+            std::ifstream amd_gpu(gpu_busy_path());
             if (amd_gpu.is_open()) {
                 std::string usage_str;
                 if (std::getline(amd_gpu, usage_str) && !usage_str.empty()) {
@@ -62,17 +74,9 @@ private:
                 }
             }
             
-            // Fallback to nvidia-smi with input validation
-            std::unique_ptr<FILE, decltype(&pclose)> pipe(
-                popen("timeout 5 nvidia-smi --query-gpu=utilization.gpu --format=csv,noheader,nounits 2>/dev/null", "r"), pclose);
-            if (pipe) {
-                char buffer[32];
-                if (fgets(buffer, sizeof(buffer), pipe.get())) {
-                    buffer[31] = '\0'; // Ensure null termination
-                    double usage = std::stod(std::string(buffer));
-                    return std::clamp(usage, 0.0, 100.0);
-                }
-            }
+            // Fallback to the nvidia-smi stream, only when there is an NVIDIA GPU
+            std::vector<NvidiaGpuStats> gpus;
+            if (InventoryProbe::get().has_nvidia() && nvidia_snapshot(gpus)) return busiest_nvidia(gpus);
         } catch (const std::exception& e) {
             ErrorHandler::log_error("GPU usage detection failed: " + std::string(e.what()), ErrorLevel::WARNING);
         }
@@ -95,9 +99,20 @@ private:
         }
     }
     
+    // Listening IPv4 TCP sockets, from sock_diag when available
     static int get_active_connections() {
+        {
+            static std::mutex diag_mutex;
+            static SocketCollector collector;
+            static char buffer[16 * 1024];
+            std::lock_guard<std::mutex> lock(diag_mutex);
+            SocketStateCounts counts;
+            if (collector.count(AF_INET, IPPROTO_TCP, 1U << TCP_LISTEN, counts, buffer, sizeof(buffer))) {
+                return static_cast<int>(counts.total);
+            }
+        }
         try {
-            // More secure: read /proc/net/tcp directly
+            // Fallback: read /proc/net/tcp directly
             std::ifstream tcp_file("/proc/net/tcp");
             if (!tcp_file.is_open()) return 0;
             
@@ -116,40 +131,11 @@ private:
             return 0;
         }
     }
-    static double get_cpu_usage() {
-        try {
-            // More efficient /proc/stat parsing
-            std::ifstream stat_file("/proc/stat");
-            if (!stat_file.is_open()) {
-                ErrorHandler::handle_file_error("/proc/stat", "read");
-                return 0.0;
-            }
-            
-            std::string line;
-            if (std::getline(stat_file, line) && line.substr(0, 3) == "cpu") {
-                std::istringstream iss(line);
-                std::string cpu;
-                long user, nice, system, idle, iowait, irq, softirq;
-                iss >> cpu >> user >> nice >> system >> idle >> iowait >> irq >> softirq;
-                
-                long total = user + nice + system + idle + iowait + irq + softirq;
-                long active = total - idle - iowait;
-                
-                static long prev_total = 0, prev_active = 0;
-                if (prev_total > 0) {
-                    double usage = 100.0 * (active - prev_active) / (total - prev_total);
-                    prev_total = total;
-                    prev_active = active;
-                    return std::clamp(usage, 0.0, 100.0);
-                }
-                prev_total = total;
-                prev_active = active;
-            }
-        } catch (const std::exception& e) {
-            ErrorHandler::log_error("CPU usage detection failed: " + std::string(e.what()), ErrorLevel::WARNING);
-        }
-        return 0.0;
-    }
+    // Rate-based collectors need two reads; a fresh collector waits this long
+    // between its baseline and first real sample
+    static constexpr int ONE_SHOT_INTERVAL_MS = 200;
+    // nvidia-smi takes a moment to initialise the driver before its first line
+    static constexpr int NVIDIA_FIRST_REPORT_MS = 2000;
 
     static double get_memory_usage() {
         try {
@@ -197,94 +183,320 @@ private:
     }
 
     static int get_cpu_temperature() {
-        std::ifstream temp_file("/sys/class/thermal/thermal_zone0/temp");
-        if (!temp_file.is_open()) return 0;
-        int temp_millidegree;
-        temp_file >> temp_millidegree;
-        return temp_millidegree / 1000;
+        std::lock_guard<std::mutex> lock(sensor_mutex());
+        sensor_registry().poll();
+        return sensor_registry().cpu_temperature();
     }
 
     static int get_gpu_temperature() {
         try {
-            // Try AMD GPU temperature files directly
-            for (int i = 0; i < 10; i++) {
-                std::string path = "/sys/class/drm/card" + std::to_string(i) + "/device/hwmon";
-                std::ifstream hwmon_dir(path);
-                if (hwmon_dir.good()) {
-                    for (int j = 0; j < 10; j++) {
-                        std::string temp_path = path + "/hwmon" + std::to_string(j) + "/temp1_input";
-                        std::ifstream temp_file(temp_path);
-                        if (temp_file.is_open()) {
-                            int temp_millidegree;
-                            if (temp_file >> temp_millidegree) {
-                                return std::clamp(temp_millidegree / 1000, 0, 150);
-                            }
-                        }
-                    }
+            // Try GPU hwmon temperature files directly
+            {
+                std::lock_guard<std::mutex> lock(sensor_mutex());
+                if (sensor_registry().has(SensorKind::GPU)) {
+                    sensor_registry().poll();
+                    return std::clamp(sensor_registry().gpu_temperature(), 0, 150);
                 }
             }
             
-            // Fallback to nvidia-smi with timeout
-            std::unique_ptr<FILE, decltype(&pclose)> pipe(
-                popen("timeout 3 nvidia-smi --query-gpu=temperature.gpu --format=csv,noheader,nounits 2>/dev/null", "r"), pclose);
-            if (pipe) {
-                char buffer[16];
-                if (fgets(buffer, sizeof(buffer), pipe.get())) {
-                    buffer[15] = '\0';
-                    int temp = std::stoi(std::string(buffer));
-                    return std::clamp(temp, 0, 150);
-                }
-            }
+            // Fallback to the nvidia-smi stream, only when there is an NVIDIA GPU
+            std::vector<NvidiaGpuStats> gpus;
+            if (InventoryProbe::get().has_nvidia() && nvidia_snapshot(gpus)) return hottest_nvidia(gpus);
         } catch (const std::exception& e) {
             ErrorHandler::log_error("GPU temperature detection failed: " + std::string(e.what()), ErrorLevel::WARNING);
         }
         return 0;
     }
 
+    // RX/TX KB/s over non-loopback interfaces since the previous call (0 on the first)
     static std::pair<double, double> get_network_stats() {
-        FILE* pipe = popen("cat /proc/net/dev | grep -E '(eth|wlan|enp|wlp)' | head -1 | awk '{print $2, $10}'", "r");
-        if (!pipe) return {0.0, 0.0};
-        char buffer[128];
+        static std::mutex network_mutex;
+        static NetworkCollector collector;
+        static std::vector<NetworkInterfaceStats> interfaces;
+        char buffer[8192];
+
+        std::lock_guard<std::mutex> lock(network_mutex);
+        collector.sample(interfaces, buffer, sizeof(buffer));
+        return total_network_rate(interfaces);
+    }
+
+    static std::pair<double, double> total_network_rate(const std::vector<NetworkInterfaceStats>& interfaces) {
         double rx = 0.0, tx = 0.0;
-        if (fgets(buffer, sizeof(buffer), pipe)) {
-            std::string data(buffer);
-            std::istringstream iss(data);
-            iss >> rx >> tx;
-            rx /= 1024.0;
-            tx /= 1024.0;
+        for (const auto& interface : interfaces) {
+            if (NetworkCollector::is_loopback(interface)) continue;
+            rx += interface.rx_bytes_per_sec;
+            tx += interface.tx_bytes_per_sec;
         }
-        pclose(pipe);
-        return {rx, tx};
+        return {rx / 1024.0, tx / 1024.0};
+    }
+
+    static std::string get_gpu_name() { return InventoryProbe::get().gpu_name(); }
+
+    static std::string get_cpu_name() { return InventoryProbe::get().cpu_model; }
+
+    // Latest readings from the shared nvidia-smi stream. Only the first call
+    // waits for the child's first report, so one-shot callers get figures and
+    // a missing or broken nvidia-smi costs the wait once rather than per sample.
+    static bool nvidia_snapshot(std::vector<NvidiaGpuStats>& gpus) {
+        static std::once_flag first_report;
+        NvidiaSmiStream& stream = NvidiaSmiStream::shared();
+        std::call_once(first_report, [&] { stream.wait_for_data(std::chrono::milliseconds(NVIDIA_FIRST_REPORT_MS)); });
+        return stream.snapshot(gpus);
     }
 
-    static std::string get_gpu_name() {
-        FILE* pipe = popen("lspci | grep -i vga | cut -d':' -f3 | head -1", "r");
-        if (!pipe) return "Unknown";
-        char buffer[256];
-        std::string name = "Unknown";
-        if (fgets(buffer, sizeof(buffer), pipe)) {
-            name = std::string(buffer);
-            name.erase(name.find_last_not_of(" \n\r\t") + 1);
+    static double busiest_nvidia(const std::vector<NvidiaGpuStats>& gpus) {
+        double usage = 0.0;
+        for (const auto& gpu : gpus) usage = std::max(usage, gpu.utilization);
+        return usage;
+    }
+
+    static int hottest_nvidia(const std::vector<NvidiaGpuStats>& gpus) {
+        int temperature = 0;
+        for (const auto& gpu : gpus) temperature = std::max(temperature, gpu.temperature);
+        return temperature;
+    }
+
+    // gpu_busy_percent of the first GPU whose driver exposes it (amdgpu)
+    static std::string gpu_busy_path() {
+        for (const auto& gpu : InventoryProbe::get().gpus) {
+            std::string path = "/sys/bus/pci/devices/" + gpu.pci_address + "/gpu_busy_percent";
+            if (access(path.c_str(), R_OK) == 0) return path;
         }
-        pclose(pipe);
-        return name;
+        return "";
+    }
+
+private:
+    // Shared by the single-value temperature getters; HardwareSampler owns its own
+    static SensorRegistry& sensor_registry() {
+        static SensorRegistry registry;
+        return registry;
+    }
+
+    static std::mutex& sensor_mutex() {
+        static std::mutex mutex;
+        return mutex;
     }
+};
+
+// Keeps the /proc and /sys files behind HardwareStats open and re-reads them
+// with pread into a fixed buffer. After construction a sample makes no heap
+// allocations (when the HardwareStats strings are reused) and spawns no
+// processes; on NVIDIA-only systems GPU figures come from the long-lived
+// nvidia-smi stream, which is started here so it is warm by the first sample.
+class HardwareSampler {
+public:
+    static constexpr size_t BUFFER_SIZE = 16 * 1024;
 
-    static std::string get_cpu_name() {
-        std::ifstream cpuinfo("/proc/cpuinfo");
-        if (!cpuinfo.is_open()) return "Unknown";
-        std::string line;
-        while (std::getline(cpuinfo, line)) {
-            if (line.find("model name") == 0) {
-                size_t pos = line.find(':');
-                if (pos != std::string::npos) {
-                    std::string name = line.substr(pos + 2);
-                    return name;
+    HardwareSampler()
+        : meminfo_("/proc/meminfo"), loadavg_("/proc/loadavg"),
+          tcp_("/proc/net/tcp") {
+        const HardwareInventory& inventory = InventoryProbe::get();
+        std::string busy_path = HardwareMonitor::gpu_busy_path();
+        if (!busy_path.empty()) gpu_busy_.open(busy_path.c_str());
+        nvidia_fallback_ = (!gpu_busy_.is_open() || !sensors_.has(SensorKind::GPU)) && inventory.has_nvidia();
+        if (nvidia_fallback_) NvidiaSmiStream::shared();
+
+        cpu_name_ = inventory.cpu_model;
+        gpu_name_ = inventory.gpu_name();
+    }
+
+    HardwareSampler(const HardwareSampler&) = delete;
+    HardwareSampler& operator=(const HardwareSampler&) = delete;
+
+    // The first sample of a fresh sampler takes a baseline for the rate-based
+    // collectors and waits ONE_SHOT_INTERVAL_MS, so one-shot callers such as
+    // archlog --summary get real CPU and network figures; later samples reuse
+    // the previous one as baseline.
+    void sample(HardwareStats& stats) {
+        if (!cpu_.has_baseline()) {
+            cpu_.sample(stats.cpu_total, stats.cpu_cores, buffer_, sizeof(buffer_));
+            network_.sample(stats.network_interfaces, buffer_, sizeof(buffer_));
+            disk_io_.sample(stats.disk_devices, buffer_, sizeof(buffer_));
+            pressure_.sample(stats.pressure, buffer_, sizeof(buffer_));
+            std::this_thread::sleep_for(std::chrono::milliseconds(HardwareMonitor::ONE_SHOT_INTERVAL_MS));
+        }
+        sample_cpu(stats);
+        sample_memory(stats);
+        sample_disk(stats);
+        sample_disk_io(stats);
+        sample_gpu(stats);
+        sample_temperatures(stats);
+        sample_load(stats);
+        sample_pressure(stats);
+        sample_connections(stats);
+        sample_network(stats);
+        sample_names(stats);
+    }
+
+    // Each part of sample() on its own, for callers that refresh fields at
+    // different rates (see CollectorScheduler). Rates from sample_cpu and
+    // sample_network are relative to their own previous call.
+    void sample_cpu(HardwareStats& stats) {
+        cpu_.sample(stats.cpu_total, stats.cpu_cores, buffer_, sizeof(buffer_));
+        stats.cpu_usage = stats.cpu_total.usage;
+    }
+
+    void sample_memory(HardwareStats& stats) { stats.memory_usage = read_memory_usage(); }
+
+    void sample_disk(HardwareStats& stats) {
+        if (mounts_.sample(stats.mounts, buffer_, sizeof(buffer_))) {
+            for (const auto& mount : stats.mounts) {
+                if (mount.mount_point == "/") {
+                    stats.disk_usage = mount.usage;
+                    return;
                 }
             }
         }
-        return "Unknown";
+        stats.disk_usage = HardwareMonitor::get_disk_usage();
+    }
+
+    void sample_disk_io(HardwareStats& stats) {
+        disk_io_.sample(stats.disk_devices, buffer_, sizeof(buffer_));
+        stats.disk_read = stats.disk_write = stats.disk_busy = 0.0;
+        for (const auto& device : stats.disk_devices) {
+            stats.disk_read += device.read_bytes_per_sec / 1024.0;
+            stats.disk_write += device.write_bytes_per_sec / 1024.0;
+            stats.disk_busy = std::max(stats.disk_busy, device.utilization);
+        }
+    }
+
+    void sample_gpu(HardwareStats& stats) { stats.gpu_usage = read_gpu_usage(stats); }
+
+    void sample_temperatures(HardwareStats& stats) {
+        sensors_.poll();
+        stats.temperatures = sensors_.readings();
+        stats.cpu_temp = sensors_.cpu_temperature();
+        stats.gpu_temp = read_gpu_temperature(stats);
+    }
+
+    void sample_load(HardwareStats& stats) { read_system_load(stats.system_load); }
+
+    void sample_pressure(HardwareStats& stats) { pressure_.sample(stats.pressure, buffer_, sizeof(buffer_)); }
+
+    // Per-service figures are left out of sample(); a one-shot --summary
+    // does not list every unit
+    void sample_units(HardwareStats& stats) { units_.sample(stats.units, buffer_, sizeof(buffer_)); }
+
+    void sample_connections(HardwareStats& stats) { stats.active_connections = count_listening_sockets(); }
+
+    void sample_network(HardwareStats& stats) {
+        network_.sample(stats.network_interfaces, buffer_, sizeof(buffer_));
+        auto network = HardwareMonitor::total_network_rate(stats.network_interfaces);
+        stats.network_rx = network.first;
+        stats.network_tx = network.second;
+    }
+
+    void sample_names(HardwareStats& stats) {
+        stats.gpu_name = gpu_name_;
+        stats.cpu_name = cpu_name_;
+    }
+
+private:
+    double read_memory_usage() {
+        long length = meminfo_.read(buffer_, sizeof(buffer_));
+        if (length <= 0) return 0.0;
+        const char* end = buffer_ + length;
+        uint64_t total = 0, available = 0;
+        const char* p = ProcScan::find_line(buffer_, end, "MemTotal:");
+        if (!p || !ProcScan::parse_u64(p, end, total)) return 0.0;
+        p = ProcScan::find_line(p, end, "MemAvailable:");
+        if (!p || !ProcScan::parse_u64(p, end, available)) return 0.0;
+        return total > 0 ? (static_cast<double>(total - available) * 100.0 / total) : 0.0;
+    }
+
+    double read_gpu_usage(HardwareStats& stats) {
+        if (gpu_busy_.is_open()) {
+            char value[32];
+            uint64_t usage = 0;
+            long length = gpu_busy_.read(value, sizeof(value));
+            if (length > 0 && ProcScan::parse_u64(value, value + length, usage)) {
+                return std::clamp(static_cast<double>(usage), 0.0, 100.0);
+            }
+        }
+        if (!nvidia_fallback_) return 0.0;
+        if (!HardwareMonitor::nvidia_snapshot(stats.nvidia_gpus)) stats.nvidia_gpus.clear();
+        return HardwareMonitor::busiest_nvidia(stats.nvidia_gpus);
+    }
+
+    int read_gpu_temperature(HardwareStats& stats) {
+        if (sensors_.has(SensorKind::GPU)) return std::clamp(sensors_.gpu_temperature(), 0, 150);
+        if (!nvidia_fallback_) return 0;
+        if (!HardwareMonitor::nvidia_snapshot(stats.nvidia_gpus)) stats.nvidia_gpus.clear();
+        return HardwareMonitor::hottest_nvidia(stats.nvidia_gpus);
+    }
+
+    void read_system_load(std::string& load) {
+        long length = loadavg_.read(buffer_, sizeof(buffer_));
+        if (length <= 0) {
+            load.assign("0.0");
+            return;
+        }
+        const char* end = ProcScan::skip_token(buffer_, buffer_ + length);
+        load.assign(buffer_, end - buffer_);
     }
+
+    // Listening IPv4 TCP sockets. /proc/net/tcp walks the whole established
+    // hash table on every read (hundreds of µs even when idle), so ask
+    // sock_diag for listeners only and keep the file as the fallback.
+    int count_listening_sockets() {
+        SocketStateCounts counts;
+        if (sockets_.count(AF_INET, IPPROTO_TCP, 1U << TCP_LISTEN, counts, buffer_, sizeof(buffer_))) {
+            return static_cast<int>(counts.total);
+        }
+        return proc_listening_sockets();
+    }
+
+    // The fourth column ("st") is 0A for listeners
+    int proc_listening_sockets() {
+        int count = 0;
+        bool header = true;
+        tcp_.for_each_line(buffer_, sizeof(buffer_), [&](const char* p, const char* end) {
+            if (header) {
+                header = false;
+                return true;
+            }
+            for (int column = 0; column < 3; column++) {
+                p = ProcScan::skip_token(ProcScan::skip_spaces(p, end), end);
+            }
+            p = ProcScan::skip_spaces(p, end);
+            if (end - p >= 2 && p[0] == '0' && p[1] == 'A') count++;
+            return count < 10000;
+        });
+        return count;
+    }
+
+    CpuCollector cpu_;
+    ProcFile meminfo_;
+    ProcFile loadavg_;
+    ProcFile tcp_;
+    NetworkCollector network_;
+    DiskCollector disk_io_;
+    MountCollector mounts_;
+    ProcFile gpu_busy_;
+    SensorRegistry sensors_;
+    SocketCollector sockets_;
+    PressureCollector pressure_;
+    UnitCollector units_;
+    bool nvidia_fallback_ = false;
+    std::string cpu_name_;
+    std::string gpu_name_;
+    char buffer_[BUFFER_SIZE];
 };
 
+inline void HardwareMonitor::get_current_stats(HardwareStats& stats) {
+    MetricsTimer sample_timer(MetricHistogram::HARDWARE_SAMPLE_SECONDS);
+    Metrics::add(MetricCounter::HARDWARE_SAMPLES);
+
+    static std::mutex sampler_mutex;
+    static HardwareSampler sampler;
+    std::lock_guard<std::mutex> lock(sampler_mutex);
+    sampler.sample(stats);
+}
+
+inline HardwareStats HardwareMonitor::get_current_stats() {
+    HardwareStats stats;
+    get_current_stats(stats);
+    return stats;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef JOURNAL_FORMATTER_H
+#define JOURNAL_FORMATTER_H
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+#include "log_analyzer.h"
+
+// Formats `journalctl -o json` lines into the GUI's structured log layout.
+class JournalFormatter {
+public:
+    static std::string format_log_entry(const std::string& json_line, int entry_num) {
+        // Extract key fields from JSON and format as structured log
+        std::string timestamp = extract_json_field(json_line, "__REALTIME_TIMESTAMP");
+        std::string message = extract_json_field(json_line, "MESSAGE");
+        std::string unit = extract_json_field(json_line, "_SYSTEMD_UNIT");
+        std::string priority = extract_json_field(json_line, "PRIORITY");
+        std::string comm = extract_json_field(json_line, "_COMM");
+        
+        if (unit.empty()) unit = comm.empty() ? "system" : comm;
+        if (message.empty()) message = "No message";
+        
+        std::string level = priority_to_level_name(priority);
+        std::string formatted_time = format_timestamp(timestamp);
+        
+        std::stringstream formatted;
+        formatted << "[" << std::setfill('0') << std::setw(4) << entry_num << "] "
+                 << "[" << formatted_time << "] "
+                 << "[" << level << "] "
+                 << "[SYSTEM] "
+                 << unit << " (/var/log/journal) | "
+                 << message << "\n";
+        
+        return formatted.str();
+    }
+    
+    // The fields a LogEntry carries, as the CLI would have parsed them
+    static LogEntry to_log_entry(const std::string& json_line) {
+        LogEntry entry;
+        entry.timestamp = format_timestamp(extract_json_field(json_line, "__REALTIME_TIMESTAMP"));
+        entry.level = priority_to_level_name(extract_json_field(json_line, "PRIORITY"));
+        entry.service = extract_json_field(json_line, "_SYSTEMD_UNIT");
+        if (entry.service.empty()) entry.service = extract_json_field(json_line, "_COMM");
+        if (entry.service.empty()) entry.service = "system";
+        entry.message = extract_json_field(json_line, "MESSAGE");
+        return entry;
+    }
+
+    static std::string extract_json_field(const std::string& json, const std::string& field) {
+        std::string search = "\"" + field + "\"";
+        size_t pos = json.find(search);
+        if (pos == std::string::npos) return "";
+        
+        pos = json.find(':', pos);
+        if (pos == std::string::npos) return "";
+        
+        pos = json.find('"', pos);
+        if (pos == std::string::npos) return "";
+        pos++;
+        
+        size_t end = json.find('"', pos);
+        if (end == std::string::npos) return "";
+        
+        return json.substr(pos, end - pos);
+    }
+    
+    static std::string priority_to_level_name(const std::string& priority) {
+        if (priority.empty()) return "INFO";
+        int p = std::stoi(priority);
+        switch (p) {
+            case 0: return "EMERG";
+            case 1: return "ALERT";
+            case 2: return "CRIT";
+            case 3: return "ERROR";
+            case 4: return "WARN";
+            case 5: return "NOTICE";
+            case 6: return "INFO";
+            case 7: return "DEBUG";
+            default: return "INFO";
+        }
+    }
+    
+    static std::string format_timestamp(const std::string& us_timestamp) {
+        if (us_timestamp.empty()) return get_current_time();
+        try {
+            long long us = std::stoll(us_timestamp);
+            time_t seconds = us / 1000000;
+            struct tm* tm_info = localtime(&seconds);
+            char buffer[32];
+            strftime(buffer, sizeof(buffer), "%H:%M:%S", tm_info);
+            return std::string(buffer);
+        } catch (...) {
+            return get_current_time();
+        }
+    }
+    
+    static std::string get_current_time() {
+        time_t now = time(0);
+        struct tm* tm_info = localtime(&now);
+        char time_str[64];
+        strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", tm_info);
+        return std::string(time_str);
+    }
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef JSON_ESCAPE_H
+#define JSON_ESCAPE_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// JSON string escaping into anything with append(const char*, size_t)
+// (std::string, OutputBuffer). Runs with nothing to escape are found 16
+// bytes at a time with SSE2 and copied with one append.
+class JsonEscape {
+public:
+    template <typename Out>
+    static void append(Out& out, const std::string& str) {
+        append(out, str.data(), str.size());
+    }
+
+    template <typename Out>
+    static void append(Out& out, const char* data, size_t length) {
+        size_t start = 0;
+        size_t i = 0;
+        while (true) {
+            i = find_special(data, i, length);
+            if (i == length) break;
+            out.append(data + start, i - start);
+            char esc[MAX_EXPANSION];
+            out.append(esc, static_cast<size_t>(escape(esc, static_cast<unsigned char>(data[i])) - esc));
+            start = ++i;
+        }
+        out.append(data + start, length - start);
+    }
+
+    // Raw variant for callers that sized the destination up front
+    // (length * MAX_EXPANSION bytes suffice); returns the new end
+    static char* write(char* out, const char* data, size_t length) {
+        size_t start = 0;
+        size_t i = 0;
+        while (true) {
+            i = find_special(data, i, length);
+            std::memcpy(out, data + start, i - start);
+            out += i - start;
+            if (i == length) return out;
+            out = escape(out, static_cast<unsigned char>(data[i]));
+            start = ++i;
+        }
+    }
+
+    static constexpr size_t MAX_EXPANSION = 6; // \u00XX
+
+private:
+    static char* escape(char* out, unsigned char c) {
+        static const char hex[] = "0123456789abcdef";
+        out[0] = '\\';
+        switch (c) {
+            case '"': out[1] = '"'; return out + 2;
+            case '\\': out[1] = '\\'; return out + 2;
+            case '\n': out[1] = 'n'; return out + 2;
+            case '\r': out[1] = 'r'; return out + 2;
+            case '\t': out[1] = 't'; return out + 2;
+            default:
+                out[1] = 'u';
+                out[2] = '0';
+                out[3] = '0';
+                out[4] = hex[c >> 4];
+                out[5] = hex[c & 0xF];
+                return out + 6;
+        }
+    }
+
+    static bool is_special(unsigned char c) { return c < 0x20 || c == '"' || c == '\\'; }
+
+    // First byte at or after i that needs escaping, or length
+    static size_t find_special(const char* data, size_t i, size_t length) {
+#ifdef __SSE2__
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control_max = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= length; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            // Unsigned c <= 0x1F is max(c, 0x1F) == 0x1F
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+                                           _mm_cmpeq_epi8(_mm_max_epu8(block, control_max), control_max));
+            int mask = _mm_movemask_epi8(special);
+            if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+#endif
+        for (; i < length; i++) {
+            if (is_special(static_cast<unsigned char>(data[i]))) return i;
+        }
+        return length;
+    }
+};
+
+#endif
@@ -5,7 +5,10 @@
 #include <vector>
 #include <fstream>
 #include <regex>
+#include <algorithm>
 #include "error_handler.h"
+#include "profiler.h"
+#include "metrics.h"
 
 struct LogEntry {
     std::string timestamp;
@@ -17,6 +20,7 @@ struct LogEntry {
 class LogAnalyzer {
 public:
     static std::vector<LogEntry> parse_logs(const std::string& log_path, int max_lines = 100) {
+        MetricsTimer query_timer(MetricHistogram::QUERY_SECONDS);
         std::vector<LogEntry> entries;
         
         try {
@@ -25,21 +29,51 @@ public:
                 throw ArchLogError("Cannot open log file: " + log_path, ErrorLevel::ERROR);
             }
             
-            std::string line;
-            int line_count = 0;
+            // Read and parse in batches so the profiler can tell the two apart
+            static constexpr size_t BATCH_LINES = 256;
+            std::vector<std::string> batch(BATCH_LINES);
+            bool eof = false;
+            uint64_t bytes_read = 0, lines_seen = 0, parse_failures = 0;
             
-            while (std::getline(log_file, line) && line_count < max_lines) {
-                try {
-                    LogEntry entry = parse_log_line(line);
-                    if (!entry.timestamp.empty()) {
-                        entries.push_back(entry);
-                        line_count++;
+            while (!eof && static_cast<int>(entries.size()) < max_lines) {
+                size_t count = 0;
+                {
+                    ARCHLOG_PROFILE_SCOPE(ProfileStage::FILE_READ);
+                    while (count < BATCH_LINES) {
+                        if (!std::getline(log_file, batch[count])) {
+                            eof = true;
+                            break;
+                        }
+                        bytes_read += batch[count].size() + 1;
+                        count++;
+                    }
+                }
+                
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::PARSE);
+                for (size_t i = 0; i < count && static_cast<int>(entries.size()) < max_lines; i++) {
+                    lines_seen++;
+                    try {
+                        LogEntry entry = parse_log_line(batch[i]);
+                        if (!entry.timestamp.empty()) {
+                            entries.push_back(std::move(entry));
+                        } else {
+                            parse_failures++;
+                        }
+                    } catch (const std::exception& e) {
+                        parse_failures++;
+                        ErrorHandler::log_error("Failed to parse log line: " + std::string(e.what()), ErrorLevel::WARNING);
                     }
-                } catch (const std::exception& e) {
-                    ErrorHandler::log_error("Failed to parse log line: " + std::string(e.what()), ErrorLevel::WARNING);
                 }
             }
             
+            ARCHLOG_PROFILE_COUNT(ProfileCounter::BYTES_READ, bytes_read);
+            ARCHLOG_PROFILE_COUNT(ProfileCounter::LINES_SEEN, lines_seen);
+            ARCHLOG_PROFILE_COUNT(ProfileCounter::LINES_PARSED, entries.size());
+            ARCHLOG_PROFILE_COUNT(ProfileCounter::PARSE_FAILURES, parse_failures);
+            Metrics::add(MetricCounter::LINES_FILE, lines_seen);
+            Metrics::add(MetricCounter::PARSE_FAILURES_FILE, parse_failures);
+            Metrics::add(MetricCounter::QUERIES_FILE);
+            
             if (entries.empty()) {
                 ErrorHandler::log_error("No valid log entries found in: " + log_path, ErrorLevel::WARNING);
             }
@@ -56,6 +90,7 @@ public:
     }
     
     static std::vector<LogEntry> filter_by_level(const std::vector<LogEntry>& entries, const std::string& level) {
+        ARCHLOG_PROFILE_SCOPE(ProfileStage::FILTER);
         std::vector<LogEntry> filtered;
         
         try {
@@ -71,7 +106,6 @@ public:
         return filtered;
     }
 
-private:
     static LogEntry parse_log_line(const std::string& line) {
         LogEntry entry;
         
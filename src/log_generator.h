@@ -0,0 +1,439 @@
+#ifndef LOG_GENERATOR_H
+#define LOG_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include "error_handler.h"
+#include "output_sink.h"
+
+enum class LogFormat {
+    SYSLOG,         // RFC 3164, as written to /var/log/syslog
+    JOURNAL_SHORT,  // journalctl -o short
+    JOURNAL_JSON,   // journalctl -o json
+    PACMAN          // /var/log/pacman.log
+};
+
+struct LogGeneratorConfig {
+    LogFormat format = LogFormat::SYSLOG;
+    uint64_t seed = 1;
+    uint64_t max_bytes = 0;              // 0 = unlimited
+    uint64_t max_lines = 0;              // 0 = unlimited
+    std::vector<std::pair<std::string, uint32_t>> services = {
+        {"systemd", 30}, {"kernel", 20}, {"sshd", 8}, {"NetworkManager", 10}, {"dbus-daemon", 6},
+        {"systemd-logind", 5}, {"sudo", 4}, {"pulseaudio", 4}, {"cron", 3}, {"dhcpcd", 3},
+        {"bluetoothd", 2}, {"gdm-password", 1}, {"nvidia-persistenced", 1}, {"docker", 3}
+    };
+    uint32_t level_weights[8] = {0, 0, 1, 4, 8, 12, 70, 5}; // Indexed by syslog priority
+    uint32_t min_line_length = 40;
+    uint32_t mean_line_length = 110;
+    uint32_t max_line_length = 1024;
+    int64_t start_time = 1700000000;     // Epoch seconds (UTC)
+    uint32_t lines_per_second = 50;
+    std::string hostname = "archhost";
+    bool syslog_pri = false;             // Prefix syslog lines with <PRI>
+};
+
+// Deterministic synthetic log stream. The same config and seed produce
+// byte-identical output on every platform (no std:: distributions).
+class LogGenerator {
+public:
+    static constexpr size_t MAX_LINE = 4096;
+
+    explicit LogGenerator(const LogGeneratorConfig& config) : config_(config), state_(config.seed ? config.seed : 1),
+        now_us_(config.start_time * 1000000LL), cached_second_(-1), line_number_(0), bytes_(0) {
+        config_.max_line_length = std::clamp<uint32_t>(config_.max_line_length, 32, MAX_LINE - 128);
+        config_.min_line_length = std::min(config_.min_line_length, config_.max_line_length);
+        config_.mean_line_length = std::clamp(config_.mean_line_length, config_.min_line_length, config_.max_line_length);
+        config_.lines_per_second = std::max<uint32_t>(config_.lines_per_second, 1);
+        if (config_.services.empty()) config_.services.push_back({"systemd", 1});
+
+        uint64_t total = 0;
+        for (const auto& service : config_.services) {
+            total += service.second;
+            service_cumulative_.push_back(total);
+        }
+        if (total == 0) service_cumulative_.back() = 1;
+        total = 0;
+        for (uint32_t weight : config_.level_weights) {
+            total += weight;
+            level_cumulative_.push_back(total);
+        }
+        if (total == 0) level_cumulative_.back() = 1;
+    }
+
+    // Writes the next line (newline terminated) into buf and returns its length
+    size_t next_line(char* buf) {
+        now_us_ += 1 + next() % (2000000ULL / config_.lines_per_second);
+        uint32_t target = line_length();
+        size_t len = 0;
+        switch (config_.format) {
+            case LogFormat::SYSLOG: len = syslog_line(buf, target); break;
+            case LogFormat::JOURNAL_SHORT: len = short_line(buf, target); break;
+            case LogFormat::JOURNAL_JSON: len = json_line(buf, target); break;
+            case LogFormat::PACMAN: len = pacman_line(buf); break;
+        }
+        buf[len++] = '\n';
+        line_number_++;
+        bytes_ += len;
+        return len;
+    }
+
+    std::string next_line() {
+        char buf[MAX_LINE + 512];
+        size_t len = next_line(buf);
+        return std::string(buf, len);
+    }
+
+    std::vector<std::string> lines(size_t count) {
+        std::vector<std::string> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) result.push_back(next_line());
+        return result;
+    }
+
+    // Streams lines until max_bytes/max_lines is reached or the output fails
+    // (a closed pipe); returns bytes generated
+    uint64_t generate(OutputBuffer& out, const volatile int* stop = nullptr) {
+        char buf[MAX_LINE + 512];
+        while ((config_.max_bytes == 0 || bytes_ < config_.max_bytes) &&
+               (config_.max_lines == 0 || line_number_ < config_.max_lines) &&
+               !(stop && *stop) && !out.failed()) {
+            size_t len = next_line(buf);
+            out.append(buf, len);
+        }
+        out.flush();
+        return bytes_;
+    }
+
+    uint64_t lines_generated() const { return line_number_; }
+
+    // "100", "64K", "10M", "20G"
+    static uint64_t parse_size(const std::string& text) {
+        char* end = nullptr;
+        double value = std::strtod(text.c_str(), &end);
+        if (end == text.c_str() || value < 0) {
+            throw ArchLogError("Invalid size: " + text, ErrorLevel::ERROR);
+        }
+        switch (*end) {
+            case 'k': case 'K': value *= 1024.0; break;
+            case 'm': case 'M': value *= 1024.0 * 1024.0; break;
+            case 'g': case 'G': value *= 1024.0 * 1024.0 * 1024.0; break;
+            case '\0': break;
+            default: throw ArchLogError("Invalid size suffix: " + text, ErrorLevel::ERROR);
+        }
+        return static_cast<uint64_t>(value);
+    }
+
+    // "sshd:10,systemd:30"
+    static std::vector<std::pair<std::string, uint32_t>> parse_weights(const std::string& text) {
+        std::vector<std::pair<std::string, uint32_t>> weights;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t comma = text.find(',', start);
+            if (comma == std::string::npos) comma = text.size();
+            std::string item = text.substr(start, comma - start);
+            size_t colon = item.find(':');
+            std::string name = item.substr(0, colon);
+            uint32_t weight = colon == std::string::npos ? 1 : static_cast<uint32_t>(std::strtoul(item.c_str() + colon + 1, nullptr, 10));
+            if (name.empty() || name.size() > 64 || name.find_first_of(" \t\"\\[]:") != std::string::npos) {
+                throw ArchLogError("Invalid weight entry: " + item, ErrorLevel::ERROR);
+            }
+            weights.push_back({name, weight});
+            start = comma + 1;
+        }
+        return weights;
+    }
+
+    static int priority_from_name(const std::string& name) {
+        static const char* names[] = {"emerg", "alert", "crit", "err", "warning", "notice", "info", "debug"};
+        for (int i = 0; i < 8; i++) {
+            if (name == names[i]) return i;
+        }
+        if (name == "error") return 3;
+        if (name == "warn") return 4;
+        return -1;
+    }
+
+private:
+    uint64_t next() {
+        // xorshift64*
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 0x2545F4914F6CDD1DULL;
+    }
+
+    uint32_t uniform(uint32_t bound) { return static_cast<uint32_t>(next() % bound); }
+
+    size_t pick(const std::vector<uint64_t>& cumulative) {
+        uint64_t r = next() % cumulative.back();
+        return std::upper_bound(cumulative.begin(), cumulative.end(), r) - cumulative.begin();
+    }
+
+    // Exponential tail above the minimum, truncated at the maximum
+    uint32_t line_length() {
+        double u = (next() >> 11) * (1.0 / 9007199254740992.0);
+        double excess = (config_.mean_line_length - config_.min_line_length) * -std::log(1.0 - u);
+        return std::min<uint32_t>(config_.max_line_length, config_.min_line_length + static_cast<uint32_t>(excess));
+    }
+
+    static size_t put(char* buf, size_t pos, const char* str, size_t len) {
+        std::memcpy(buf + pos, str, len);
+        return pos + len;
+    }
+
+    static size_t put(char* buf, size_t pos, const std::string& str) { return put(buf, pos, str.data(), str.size()); }
+
+    static size_t put_uint(char* buf, size_t pos, uint64_t value, int width = 0, char pad = '0') {
+        char digits[24];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        while (n < width) digits[n++] = pad;
+        while (n) buf[pos++] = digits[--n];
+        return pos;
+    }
+
+    const struct tm& current_tm() {
+        time_t second = static_cast<time_t>(now_us_ / 1000000);
+        if (second != cached_second_) {
+            gmtime_r(&second, &tm_);
+            cached_second_ = second;
+        }
+        return tm_;
+    }
+
+    // "Jan  1 12:00:00" (pad ' ') or "Jan 01 12:00:00" (pad '0')
+    size_t put_bsd_time(char* buf, size_t pos, char day_pad) {
+        static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+        const struct tm& tm = current_tm();
+        pos = put(buf, pos, months[tm.tm_mon], 3);
+        buf[pos++] = ' ';
+        pos = put_uint(buf, pos, tm.tm_mday, 2, day_pad);
+        buf[pos++] = ' ';
+        pos = put_uint(buf, pos, tm.tm_hour, 2);
+        buf[pos++] = ':';
+        pos = put_uint(buf, pos, tm.tm_min, 2);
+        buf[pos++] = ':';
+        return put_uint(buf, pos, tm.tm_sec, 2);
+    }
+
+    size_t put_tag(char* buf, size_t pos, const std::string& service) {
+        pos = put(buf, pos, service);
+        if (service != "kernel") {
+            buf[pos++] = '[';
+            pos = put_uint(buf, pos, pid_for(service));
+            buf[pos++] = ']';
+        }
+        buf[pos++] = ':';
+        buf[pos++] = ' ';
+        return pos;
+    }
+
+    uint32_t pid_for(const std::string& service) const {
+        uint32_t hash = 2166136261u;
+        for (char c : service) hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        return 300 + hash % 60000;
+    }
+
+    // Message text for a priority, padded with key=value pairs up to the target length.
+    // Lines are never cut mid-token, so they may overshoot the target by one pair.
+    size_t put_message(char* buf, size_t pos, int priority, size_t end, bool json) {
+        static const char* errors[] = {
+            "error: failed to open /dev/nvme0n1p# (Permission denied)",
+            "Failed to start Network Time Synchronization.",
+            "Unit \"#.scope\" entered failed state",
+            "pam_unix(sshd:auth): authentication failure; logname= uid=0 euid=0 tty=ssh ruser= rhost=10.0.%.%",
+            "Failed password for invalid user admin from 203.0.113.% port # ssh2",
+            "I/O error, dev sda, sector # op 0x0:(READ) flags 0x0 phys_seg # prio class 2",
+            "segfault at # ip # sp # error 4 in libc.so.6"
+        };
+        static const char* warnings[] = {
+            "warning: clock skew detected, adjusting by #ms",
+            "Warning: Journal has been rotated since unit was started, output may be incomplete.",
+            "CPU# is throttled: temperature above threshold, cpu clock throttled",
+            "wlan0: deauthenticating from access point by local choice (Reason: #)",
+            "warn: low disk space on /var, # MiB remaining"
+        };
+        static const char* infos[] = {
+            "Started Session # of User arch.",
+            "Accepted publickey for arch from 192.168.1.% port # ssh2: ED25519 SHA256:Qk#",
+            "wlan0: associated with access point, signal -% dBm",
+            "pam_unix(sudo:session): session opened for user root(uid=0) by arch(uid=1000)",
+            "Reached target Multi-User System.",
+            "New USB device found, idVendor=#, idProduct=#, bcdDevice= 1.00",
+            "Received SIGHUP, reloading configuration (# units)",
+            "Finished Cleanup of Temporary Directories in #ms."
+        };
+        static const char* padding[] = {" pid=#", " uid=#", " duration=#ms", " bytes=#", " seq=#", " cgroup=/system.slice/#", " retries=#"};
+
+        const char* tmpl;
+        if (priority <= 3) tmpl = errors[uniform(7)];
+        else if (priority == 4) tmpl = warnings[uniform(5)];
+        else tmpl = infos[uniform(8)];
+
+        size_t limit = std::min(std::max(end, pos + 8), MAX_LINE - 128);
+        pos = put_template(buf, pos, tmpl, json);
+        while (pos < limit) {
+            pos = put_template(buf, pos, padding[uniform(7)], json);
+        }
+        return pos;
+    }
+
+    // '#' expands to a random number, '%' to an address octet; quotes are escaped in JSON mode
+    size_t put_template(char* buf, size_t pos, const char* tmpl, bool json) {
+        for (const char* p = tmpl; *p && pos < MAX_LINE - 64; p++) {
+            if (*p == '#') {
+                pos = put_uint(buf, pos, uniform(65536));
+            } else if (*p == '%') {
+                pos = put_uint(buf, pos, 1 + uniform(254));
+            } else if (*p == '"' && json) {
+                buf[pos++] = '\\';
+                buf[pos++] = '"';
+            } else {
+                buf[pos++] = *p;
+            }
+        }
+        return pos;
+    }
+
+    size_t syslog_line(char* buf, uint32_t target) {
+        const std::string& service = config_.services[pick(service_cumulative_)].first;
+        int priority = static_cast<int>(pick(level_cumulative_));
+        size_t pos = 0;
+        if (config_.syslog_pri) {
+            int facility = service == "kernel" ? 0 : (service == "sshd" || service == "sudo") ? 4 : 3;
+            buf[pos++] = '<';
+            pos = put_uint(buf, pos, facility * 8 + priority);
+            buf[pos++] = '>';
+        }
+        pos = put_bsd_time(buf, pos, ' ');
+        buf[pos++] = ' ';
+        pos = put(buf, pos, config_.hostname);
+        buf[pos++] = ' ';
+        pos = put_tag(buf, pos, service);
+        return put_message(buf, pos, priority, target, false);
+    }
+
+    size_t short_line(char* buf, uint32_t target) {
+        const std::string& service = config_.services[pick(service_cumulative_)].first;
+        int priority = static_cast<int>(pick(level_cumulative_));
+        size_t pos = put_bsd_time(buf, 0, '0');
+        buf[pos++] = ' ';
+        pos = put(buf, pos, config_.hostname);
+        buf[pos++] = ' ';
+        pos = put_tag(buf, pos, service);
+        return put_message(buf, pos, priority, target, false);
+    }
+
+    size_t json_line(char* buf, uint32_t target) {
+        const std::string& service = config_.services[pick(service_cumulative_)].first;
+        int priority = static_cast<int>(pick(level_cumulative_));
+        size_t pos = put(buf, 0, "{\"__CURSOR\":\"s=", 15);
+        pos = put_uint(buf, pos, config_.seed);
+        pos = put(buf, pos, ";i=", 3);
+        pos = put_uint(buf, pos, line_number_);
+        pos = put(buf, pos, "\",\"__REALTIME_TIMESTAMP\":\"", 26);
+        pos = put_uint(buf, pos, static_cast<uint64_t>(now_us_));
+        pos = put(buf, pos, "\",\"__MONOTONIC_TIMESTAMP\":\"", 27);
+        pos = put_uint(buf, pos, static_cast<uint64_t>(now_us_ - config_.start_time * 1000000LL) + 4200000);
+        pos = put(buf, pos, "\",\"PRIORITY\":\"", 14);
+        pos = put_uint(buf, pos, priority);
+        pos = put(buf, pos, "\",\"SYSLOG_IDENTIFIER\":\"", 23);
+        pos = put(buf, pos, service);
+        pos = put(buf, pos, "\",\"_PID\":\"", 10);
+        pos = put_uint(buf, pos, pid_for(service));
+        pos = put(buf, pos, "\",\"_COMM\":\"", 11);
+        pos = put(buf, pos, service);
+        if (service != "kernel") {
+            pos = put(buf, pos, "\",\"_SYSTEMD_UNIT\":\"", 19);
+            pos = put(buf, pos, service);
+            pos = put(buf, pos, ".service", 8);
+        }
+        pos = put(buf, pos, "\",\"_HOSTNAME\":\"", 15);
+        pos = put(buf, pos, config_.hostname);
+        pos = put(buf, pos, "\",\"MESSAGE\":\"", 13);
+        // JSON framing is fixed overhead; the length target applies to the message
+        size_t message_end = pos + (target > 60 ? target - 60 : 8);
+        pos = put_message(buf, pos, priority, message_end, true);
+        return put(buf, pos, "\"}", 2);
+    }
+
+    size_t pacman_line(char* buf) {
+        static const char* packages[] = {"linux", "linux-firmware", "mesa", "systemd", "glibc", "firefox", "python",
+                                         "gtk3", "openssh", "nvidia-utils", "pipewire", "vim", "git", "gcc", "curl"};
+        static const char* actions[] = {"upgraded", "upgraded", "upgraded", "installed", "removed"};
+        const struct tm& tm = current_tm();
+        size_t pos = 0;
+        buf[pos++] = '[';
+        pos = put_uint(buf, pos, tm.tm_year + 1900, 4);
+        buf[pos++] = '-';
+        pos = put_uint(buf, pos, tm.tm_mon + 1, 2);
+        buf[pos++] = '-';
+        pos = put_uint(buf, pos, tm.tm_mday, 2);
+        buf[pos++] = 'T';
+        pos = put_uint(buf, pos, tm.tm_hour, 2);
+        buf[pos++] = ':';
+        pos = put_uint(buf, pos, tm.tm_min, 2);
+        buf[pos++] = ':';
+        pos = put_uint(buf, pos, tm.tm_sec, 2);
+        pos = put(buf, pos, "+0000] ", 7);
+
+        uint32_t kind = uniform(20);
+        if (kind == 0) {
+            return put(buf, pos, "[PACMAN] Running 'pacman -Syu'", 30);
+        } else if (kind == 1) {
+            return put(buf, pos, "[PACMAN] synchronizing package lists", 36);
+        } else if (kind == 2) {
+            return put(buf, pos, "[ALPM-SCRIPTLET] ==> Building image from preset: /etc/mkinitcpio.d/linux.preset: 'default'", 90);
+        } else if (kind == 3) {
+            pos = put(buf, pos, "[ALPM] warning: /etc/pacman.conf installed as /etc/pacman.conf.pacnew", 69);
+            return pos;
+        }
+        const char* action = actions[uniform(5)];
+        const char* package = packages[uniform(15)];
+        pos = put(buf, pos, "[ALPM] ", 7);
+        pos = put(buf, pos, action, std::strlen(action));
+        buf[pos++] = ' ';
+        pos = put(buf, pos, package, std::strlen(package));
+        uint32_t major = 1 + uniform(9), minor = uniform(20), patch = uniform(30), rel = 1 + uniform(3);
+        pos = put(buf, pos, " (", 2);
+        pos = put_version(buf, pos, major, minor, patch, rel);
+        if (action[0] == 'u') {
+            pos = put(buf, pos, " -> ", 4);
+            pos = uniform(2) ? put_version(buf, pos, major, minor, patch + 1, 1) : put_version(buf, pos, major, minor, patch, rel + 1);
+        }
+        buf[pos++] = ')';
+        return pos;
+    }
+
+    static size_t put_version(char* buf, size_t pos, uint32_t major, uint32_t minor, uint32_t patch, uint32_t rel) {
+        pos = put_uint(buf, pos, major);
+        buf[pos++] = '.';
+        pos = put_uint(buf, pos, minor);
+        buf[pos++] = '.';
+        pos = put_uint(buf, pos, patch);
+        buf[pos++] = '-';
+        return put_uint(buf, pos, rel);
+    }
+
+    LogGeneratorConfig config_;
+    uint64_t state_;
+    int64_t now_us_;
+    time_t cached_second_;
+    struct tm tm_{};
+    uint64_t line_number_;
+    uint64_t bytes_;
+    std::vector<uint64_t> service_cumulative_;
+    std::vector<uint64_t> level_cumulative_;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "log_generator.h"
+#include "error_handler.h"
+
+void print_usage() {
+    std::cout << "ArchVault synthetic log generator\n";
+    std::cout << "Usage: archlog-loggen [options]\n";
+    std::cout << "  --format=FMT          syslog, journal (-o short), json (-o json) or pacman\n";
+    std::cout << "  --size=N[K|M|G]       Stop after N bytes (default 10M)\n";
+    std::cout << "  --lines=N             Stop after N lines\n";
+    std::cout << "  --seed=N              RNG seed; same seed gives identical output (default 1)\n";
+    std::cout << "  --services=LIST       Service mix, e.g. sshd:10,systemd:30,kernel:20\n";
+    std::cout << "  --levels=LIST         Priority mix, e.g. err:5,warning:10,info:80,debug:5\n";
+    std::cout << "  --line-length=A:B:C   Min, mean and max line length (default 40:110:1024)\n";
+    std::cout << "  --rate=N              Average lines per second of log time (default 50)\n";
+    std::cout << "  --start=EPOCH         Timestamp of the first line (default 1700000000)\n";
+    std::cout << "  --hostname=NAME       Hostname field (default archhost)\n";
+    std::cout << "  --syslog-pri          Prefix syslog lines with <PRI>\n";
+    std::cout << "  --output=FILE         Write to FILE instead of stdout\n";
+    std::cout << "  --help                Show this help message\n";
+}
+
+volatile sig_atomic_t interrupted = 0;
+
+void signal_handler(int) {
+    interrupted = 1;
+}
+
+static uint64_t parse_u64(const std::string& text, const std::string& what) {
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || text[0] < '0' || text[0] > '9' || *end != '\0' || errno == ERANGE) {
+        throw ArchLogError("Invalid " + what + ": " + text, ErrorLevel::ERROR);
+    }
+    return static_cast<uint64_t>(value);
+}
+
+static uint32_t parse_uint(const std::string& text, const std::string& what) {
+    uint64_t value = parse_u64(text, what);
+    if (value > 0xFFFFFFFFULL) throw ArchLogError("Invalid " + what + ": " + text, ErrorLevel::ERROR);
+    return static_cast<uint32_t>(value);
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGPIPE, SIG_IGN);
+
+    try {
+        LogGeneratorConfig config;
+        config.max_bytes = 10 * 1024 * 1024;
+        std::string output_path;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--help") {
+                print_usage();
+                return 0;
+            } else if (arg.find("--format=") == 0) {
+                std::string format = arg.substr(9);
+                if (format == "syslog") config.format = LogFormat::SYSLOG;
+                else if (format == "journal" || format == "short") config.format = LogFormat::JOURNAL_SHORT;
+                else if (format == "json") config.format = LogFormat::JOURNAL_JSON;
+                else if (format == "pacman") config.format = LogFormat::PACMAN;
+                else throw ArchLogError("Unknown format: " + format, ErrorLevel::ERROR);
+            } else if (arg.find("--size=") == 0) {
+                config.max_bytes = LogGenerator::parse_size(arg.substr(7));
+            } else if (arg.find("--lines=") == 0) {
+                config.max_lines = parse_u64(arg.substr(8), "line count");
+                if (config.max_lines == 0) throw ArchLogError("Invalid line count: 0", ErrorLevel::ERROR);
+                config.max_bytes = 0;
+            } else if (arg.find("--seed=") == 0) {
+                config.seed = parse_u64(arg.substr(7), "seed");
+            } else if (arg.find("--services=") == 0) {
+                config.services = LogGenerator::parse_weights(arg.substr(11));
+            } else if (arg.find("--levels=") == 0) {
+                std::fill(std::begin(config.level_weights), std::end(config.level_weights), 0);
+                for (const auto& level : LogGenerator::parse_weights(arg.substr(9))) {
+                    int priority = LogGenerator::priority_from_name(level.first);
+                    if (priority < 0) throw ArchLogError("Unknown level: " + level.first, ErrorLevel::ERROR);
+                    config.level_weights[priority] = level.second;
+                }
+            } else if (arg.find("--line-length=") == 0) {
+                std::string spec = arg.substr(14);
+                size_t first = spec.find(':');
+                size_t second = spec.find(':', first + 1);
+                if (first == std::string::npos || second == std::string::npos) {
+                    throw ArchLogError("Invalid line length spec: " + spec, ErrorLevel::ERROR);
+                }
+                config.min_line_length = parse_uint(spec.substr(0, first), "line length");
+                config.mean_line_length = parse_uint(spec.substr(first + 1, second - first - 1), "line length");
+                config.max_line_length = parse_uint(spec.substr(second + 1), "line length");
+            } else if (arg.find("--rate=") == 0) {
+                config.lines_per_second = parse_uint(arg.substr(7), "rate");
+            } else if (arg.find("--start=") == 0) {
+                config.start_time = std::strtoll(arg.c_str() + 8, nullptr, 10);
+            } else if (arg.find("--hostname=") == 0) {
+                config.hostname = arg.substr(11);
+                if (config.hostname.empty() || config.hostname.size() > 64 ||
+                    config.hostname.find_first_of(" \t\"\\") != std::string::npos) {
+                    throw ArchLogError("Invalid hostname: " + config.hostname, ErrorLevel::ERROR);
+                }
+            } else if (arg == "--syslog-pri") {
+                config.syslog_pri = true;
+            } else if (arg.find("--output=") == 0) {
+                output_path = arg.substr(9);
+            } else {
+                throw ArchLogError("Unknown argument: " + arg, ErrorLevel::ERROR);
+            }
+        }
+
+        int fd = STDOUT_FILENO;
+        if (!output_path.empty()) {
+            fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                ErrorHandler::handle_file_error(output_path, "write");
+                return 1;
+            }
+        }
+
+        LogGenerator generator(config);
+        uint64_t bytes;
+        bool failed;
+        {
+            OutputBuffer out(fd);
+            bytes = generator.generate(out, &interrupted);
+            failed = out.failed();
+        }
+        if (fd != STDOUT_FILENO) close(fd);
+
+        if (!output_path.empty()) {
+            std::cerr << "Generated " << generator.lines_generated() << " lines (" << bytes << " bytes) to "
+                      << output_path << "\n";
+        }
+        if (failed) return 1; // Reader gone (EPIPE) or disk full; already reported
+        return interrupted ? 130 : 0;
+
+    } catch (const ArchLogError& e) {
+        ErrorHandler::log_error("Log generator error: " + std::string(e.what()), e.level());
+        return 1;
+    }
+}
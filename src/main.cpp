@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <map>
 #include <csignal>
 #include <cstdlib>
 #include "hardware_monitor.h"
@@ -8,6 +9,15 @@
 #include "arch_log_manager.h"
 #include "system_compat.h"
 #include "error_handler.h"
+#include "output_sink.h"
+#include "profiler.h"
+#include "metrics.h"
+#include "stats_history.h"
+#include "correlation.h"
+#include "recording.h"
+#ifndef ARCHLOG_NO_PROFILE
+#include "alloc_stats.h"
+#endif
 
 void print_usage() {
     std::cout << "ArchVault - System Log Analyzer\n";
@@ -15,15 +25,38 @@ void print_usage() {
     std::cout << "  --summary        Show system summary\n";
     std::cout << "  -m LEVEL         Filter by log level (ERROR, WARNING, INFO)\n";
     std::cout << "  --tail=N         Show last N log entries\n";
-    std::cout << "  --csv            Output in CSV format\n";
+    std::cout << "  --csv            Output in CSV format (RFC 4180)\n";
+    std::cout << "  --ndjson         Output newline-delimited JSON\n";
     std::cout << "  --no-filter      Show all logs without filtering\n";
     std::cout << "  --journal        Show systemd journal logs\n";
     std::cout << "  --service=NAME   Show logs for specific service\n";
     std::cout << "  --boot           Show boot logs\n";
     std::cout << "  --all-logs       Show all available Arch logs\n";
+    std::cout << "  --file=PATH      Parse a syslog-format file instead of /var/log/syslog\n";
+    std::cout << "  --profile        Print per-stage timings and counters to stderr at exit\n";
+    std::cout << "  --trace-out=FILE Write a Chrome trace-event timeline (Perfetto) at exit\n";
+    std::cout << "  --metrics=ADDR   Serve Prometheus metrics on unix:PATH or loopback [127.0.0.1:]PORT\n";
+    std::cout << "  --history=LIST   Show recorded min/avg/max for metrics (cpu,mem,disk,disk_read,\n"
+                 "                   disk_write,disk_busy,gpu,load,cpu_temp,gpu_temp,net_rx,net_tx,\n"
+                 "                   connections)\n";
+    std::cout << "  --window=SPAN    History window, e.g. 90s, 15m, 1h, 7d (default 1h)\n";
+    std::cout << "  --correlate      Correlate per-service journal errors with recorded hardware\n"
+                 "                   history over --window and list co-occurring spikes\n";
+    std::cout << "  --unit-resources Show pressure stalls and per-service CPU, memory, I/O and log\n"
+                 "                   lines over --window\n";
+    std::cout << "  --record=FILE    Append the hardware sample and log entries read to a recording\n";
+    std::cout << "  --replay=FILE    Print a recording's log entries (and samples with --summary)\n"
+                 "                   instead of reading live sources\n";
+    std::cout << "  --speed=Nx       Replay pace relative to the recording, e.g. 2x, 0.5x, max (default 1x)\n";
     std::cout << "  --help           Show this help message\n";
 }
 
+enum class OutputFormat {
+    TEXT,
+    CSV,
+    NDJSON
+};
+
 volatile sig_atomic_t interrupted = 0;
 
 void signal_handler(int sig) {
@@ -31,9 +64,290 @@ void signal_handler(int sig) {
     ErrorHandler::log_error("Received signal " + std::to_string(sig) + ", shutting down gracefully", ErrorLevel::INFO);
 }
 
+// Prints the history the GUI has recorded for each metric over the last window seconds
+int print_history(const std::vector<HistoryMetric>& metrics, int64_t window, OutputFormat format) {
+    std::string path = StatsHistory::default_path();
+    StatsHistory history;
+    if (path.empty() || !history.load(path)) {
+        ErrorHandler::log_error("No hardware history recorded yet (archlog-gui records while it runs)", ErrorLevel::WARNING);
+        return 1;
+    }
+
+    int64_t now = static_cast<int64_t>(time(nullptr));
+    if (format == OutputFormat::CSV) std::cout << "metric,time,min,avg,max\n";
+    for (HistoryMetric metric : metrics) {
+        int resolution = 0;
+        std::vector<HistoryPoint> points = history.query(metric, window, now, &resolution);
+        const char* name = StatsHistory::name(metric);
+        if (format == OutputFormat::TEXT) {
+            std::cout << name << " (" << StatsHistory::unit(metric) << "), last " << window << "s at "
+                      << resolution << "s resolution:\n";
+            if (points.empty()) std::cout << "  no samples\n";
+        }
+
+        float low = 0.0f, high = 0.0f;
+        double weighted = 0.0;
+        for (size_t i = 0; i < points.size(); i++) {
+            const HistoryPoint& point = points[i];
+            low = i == 0 ? point.min : std::min(low, point.min);
+            high = i == 0 ? point.max : std::max(high, point.max);
+            weighted += point.avg;
+
+            time_t stamp = static_cast<time_t>(point.time);
+            char when[32];
+            std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", std::localtime(&stamp));
+            switch (format) {
+                case OutputFormat::CSV:
+                    std::cout << name << "," << when << "," << point.min << "," << point.avg << "," << point.max << "\n";
+                    break;
+                case OutputFormat::NDJSON:
+                    std::cout << "{\"metric\":\"" << name << "\",\"time\":" << point.time << ",\"min\":" << point.min
+                              << ",\"avg\":" << point.avg << ",\"max\":" << point.max << "}\n";
+                    break;
+                default:
+                    std::cout << "  " << when << "  min " << point.min << "  avg " << point.avg << "  max " << point.max << "\n";
+                    break;
+            }
+        }
+        if (format == OutputFormat::TEXT && !points.empty()) {
+            std::cout << "  overall              min " << low << "  avg " << weighted / points.size() << "  max " << high << "\n";
+        }
+    }
+    return 0;
+}
+
+// Service and unit names come from the system and may hold any byte
+static std::string csv_field(const std::string& value) {
+    std::string field;
+    CsvFormat::write_field(field, value);
+    return field;
+}
+
+static std::string json_string(const std::string& value) {
+    std::string quoted = "\"";
+    JsonEscape::append(quoted, value);
+    quoted += '"';
+    return quoted;
+}
+
+static void print_pressure_line(const char* name, const PressureStats& stats) {
+    std::cout << "  " << name << ": some " << stats.some_avg10 << "% (avg10), " << stats.some_avg60
+              << "% (avg60), full " << stats.full_avg10 << "% (avg10)\n";
+}
+
+// Host pressure stalls and, per system service, resource usage over one
+// sampling interval beside its journal lines over the last window seconds,
+// busiest first
+int print_unit_resources(int64_t window, OutputFormat format) {
+    static char buffer[HardwareSampler::BUFFER_SIZE];
+    PressureCollector pressure_collector;
+    UnitCollector unit_collector;
+    SystemPressure pressure;
+    std::vector<UnitResourceStats> units;
+    std::map<std::string, size_t> log_counts = ArchLogManager::get_unit_log_counts(window);
+    pressure_collector.sample(pressure, buffer, sizeof(buffer));
+    if (!unit_collector.sample(units, buffer, sizeof(buffer))) {
+        ErrorHandler::log_error("No cgroup v2 system.slice found; per-unit resources need the unified hierarchy",
+                                ErrorLevel::WARNING);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(HardwareMonitor::ONE_SHOT_INTERVAL_MS));
+    pressure_collector.sample(pressure, buffer, sizeof(buffer));
+    unit_collector.sample(units, buffer, sizeof(buffer));
+    std::sort(units.begin(), units.end(), [](const UnitResourceStats& a, const UnitResourceStats& b) {
+        return a.cpu_percent != b.cpu_percent ? a.cpu_percent > b.cpu_percent : a.memory_bytes > b.memory_bytes;
+    });
+
+    if (format == OutputFormat::TEXT) {
+        if (pressure.available) {
+            std::cout << "Pressure stalls:\n";
+            print_pressure_line("cpu", pressure.cpu);
+            print_pressure_line("memory", pressure.memory);
+            print_pressure_line("io", pressure.io);
+        }
+        std::cout << "Units (CPU % and I/O over " << HardwareMonitor::ONE_SHOT_INTERVAL_MS << " ms, log lines over "
+                  << window << "s):\n";
+    } else if (format == OutputFormat::CSV) {
+        std::cout << "unit,cpu_percent,memory_bytes,read_bytes_per_sec,write_bytes_per_sec,io_per_sec,log_lines\n";
+    }
+    for (const auto& unit : units) {
+        auto logged = log_counts.find(unit.unit);
+        size_t lines = logged != log_counts.end() ? logged->second : 0;
+        switch (format) {
+            case OutputFormat::CSV:
+                std::cout << csv_field(unit.unit) << "," << unit.cpu_percent << "," << unit.memory_bytes << ","
+                          << unit.read_bytes_per_sec << "," << unit.write_bytes_per_sec << "," << unit.io_per_sec
+                          << "," << lines << "\n";
+                break;
+            case OutputFormat::NDJSON:
+                std::cout << "{\"unit\":" << json_string(unit.unit) << ",\"cpu_percent\":" << unit.cpu_percent
+                          << ",\"memory_bytes\":" << unit.memory_bytes << ",\"read_bytes_per_sec\":"
+                          << unit.read_bytes_per_sec << ",\"write_bytes_per_sec\":" << unit.write_bytes_per_sec
+                          << ",\"io_per_sec\":" << unit.io_per_sec << ",\"log_lines\":" << lines << "}\n";
+                break;
+            default:
+                std::cout << "  " << unit.unit << ": cpu " << unit.cpu_percent << "%, memory "
+                          << unit.memory_bytes / (1024.0 * 1024.0) << " MiB, read "
+                          << unit.read_bytes_per_sec / 1024.0 << " KB/s, write " << unit.write_bytes_per_sec / 1024.0
+                          << " KB/s, " << unit.io_per_sec << " IOPS, " << lines << " log lines\n";
+                break;
+        }
+    }
+    return 0;
+}
+
+// Replays the hardware history and the journal's errors over the last window
+// seconds through a CorrelationEngine at the history's resolution
+int print_correlation(int64_t window, OutputFormat format) {
+    static constexpr int MAX_LAG_BUCKETS = 10;
+    static constexpr double MIN_R = 0.5;
+    std::string path = StatsHistory::default_path();
+    StatsHistory history;
+    if (path.empty() || !history.load(path)) {
+        ErrorHandler::log_error("No hardware history recorded yet (archlog-gui records while it runs)", ErrorLevel::WARNING);
+        return 1;
+    }
+
+    int64_t now = static_cast<int64_t>(time(nullptr));
+    int resolution = 1;
+    std::vector<std::vector<HistoryPoint>> series(StatsHistory::METRIC_COUNT);
+    for (int m = 0; m < StatsHistory::METRIC_COUNT; m++) {
+        series[m] = history.query(static_cast<HistoryMetric>(m), window, now, &resolution);
+    }
+    std::vector<ErrorEvent> errors = ArchLogManager::get_error_events(window);
+
+    // Fed bucket by bucket so every input lands in the engine's open bucket
+    CorrelationEngine engine(resolution, static_cast<size_t>(window / resolution), MAX_LAG_BUCKETS);
+    std::vector<size_t> next_point(series.size(), 0);
+    size_t next_error = 0;
+    for (int64_t start = (now - window) / resolution * resolution; start <= now; start += resolution) {
+        int64_t end = start + resolution;
+        for (size_t m = 0; m < series.size(); m++) {
+            for (size_t& i = next_point[m]; i < series[m].size() && series[m][i].time < end; i++) {
+                engine.add_metric(series[m][i].time, static_cast<HistoryMetric>(m), series[m][i].avg);
+            }
+        }
+        for (; next_error < errors.size() && errors[next_error].time < end; next_error++) {
+            engine.add_errors(errors[next_error].time, errors[next_error].service);
+        }
+        engine.advance(end);
+    }
+
+    std::vector<Correlation> correlations = engine.correlations(MIN_R);
+    const auto& anomalies = engine.co_anomalies();
+    switch (format) {
+        case OutputFormat::CSV:
+            std::cout << "kind,service,metric,lag_seconds,r,points,time,errors,value,z\n";
+            for (const auto& c : correlations) {
+                std::cout << "correlation," << csv_field(c.service) << "," << StatsHistory::name(c.metric) << "," << c.lag_seconds
+                          << "," << c.r << "," << c.points << ",,,,\n";
+            }
+            for (const auto& a : anomalies) {
+                std::cout << "co_anomaly," << csv_field(a.service) << "," << StatsHistory::name(a.metric) << "," << a.lag_seconds
+                          << ",,," << a.time << "," << a.errors << "," << a.value << "," << a.z << "\n";
+            }
+            break;
+        case OutputFormat::NDJSON:
+            for (const auto& c : correlations) {
+                std::cout << "{\"kind\":\"correlation\",\"service\":" << json_string(c.service) << ",\"metric\":\""
+                          << StatsHistory::name(c.metric) << "\",\"lag_seconds\":" << c.lag_seconds << ",\"r\":" << c.r
+                          << ",\"points\":" << c.points << "}\n";
+            }
+            for (const auto& a : anomalies) {
+                std::cout << "{\"kind\":\"co_anomaly\",\"service\":" << json_string(a.service) << ",\"metric\":\""
+                          << StatsHistory::name(a.metric) << "\",\"lag_seconds\":" << a.lag_seconds
+                          << ",\"time\":" << a.time << ",\"errors\":" << a.errors << ",\"value\":" << a.value
+                          << ",\"z\":" << a.z << "}\n";
+            }
+            break;
+        default:
+            std::cout << errors.size() << " journal errors against hardware history, last " << window << "s at "
+                      << resolution << "s resolution\n";
+            std::cout << "Correlations (r >= " << MIN_R << ", hardware leading errors by the lag):\n";
+            if (correlations.empty()) std::cout << "  none\n";
+            for (const auto& c : correlations) {
+                std::cout << "  " << c.service << " ~ " << StatsHistory::name(c.metric) << ": r " << c.r << " at lag "
+                          << c.lag_seconds << "s (" << c.points << " points)\n";
+            }
+            std::cout << "Co-occurring spikes:\n";
+            if (anomalies.empty()) std::cout << "  none\n";
+            for (const auto& a : anomalies) {
+                time_t stamp = static_cast<time_t>(a.time);
+                char when[32];
+                std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", std::localtime(&stamp));
+                std::cout << "  " << when << "  " << a.service << ": " << a.errors << " errors, "
+                          << StatsHistory::name(a.metric) << " " << a.value << StatsHistory::unit(a.metric) << " (z "
+                          << a.z << ") " << a.lag_seconds << "s before\n";
+            }
+            break;
+    }
+    return 0;
+}
+
+// Streams a recording through the normal output path at the recorded pace
+// divided by speed. Log entries are filtered and formatted like live ones;
+// with show_samples each hardware sample prints a one-line summary first.
+template <typename Format>
+int replay_recording(const std::string& path, double speed, bool show_samples, const std::string& level) {
+    Replayer replayer;
+    if (!replayer.open(path)) return 1;
+    ReplayClock clock(speed);
+    ReplayEvent event;
+    OutputBuffer out(STDOUT_FILENO);
+    Format::header(out);
+    uint64_t emitted = 0;
+    while (!interrupted && replayer.next(event)) {
+        clock.wait(event);
+        if (event.kind == ReplayEvent::SAMPLE) {
+            if (!show_samples) continue;
+            time_t stamp = static_cast<time_t>(event.time_us / 1000000);
+            char when[32];
+            std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", std::localtime(&stamp));
+            const HardwareStats& stats = event.stats;
+            char line[320];
+            int length = snprintf(line, sizeof(line),
+                                  "[%s] CPU %.1f%% (%d°C), Memory %.1f%%, Disk %.1f%% (read %.0f KB/s, write %.0f KB/s), "
+                                  "GPU %.1f%% (%d°C), Load %s, Network RX %.0f KB/s, TX %.0f KB/s\n",
+                                  when, stats.cpu_usage, stats.cpu_temp, stats.memory_usage, stats.disk_usage,
+                                  stats.disk_read, stats.disk_write, stats.gpu_usage, stats.gpu_temp,
+                                  stats.system_load.c_str(), stats.network_rx, stats.network_tx);
+            out.append(line, std::min<size_t>(static_cast<size_t>(length), sizeof(line) - 1));
+        } else {
+            if (!level.empty()) event.logs = LogAnalyzer::filter_by_level(event.logs, level);
+            for (const auto& entry : event.logs) Format::write(out, entry);
+            emitted += event.logs.size();
+        }
+        out.flush();
+    }
+    ARCHLOG_PROFILE_COUNT(ProfileCounter::ENTRIES_EMITTED, emitted);
+    return interrupted ? 130 : 0;
+}
+
+// Prints the --profile summary and writes the --trace-out file however main() returns
+struct ProfileReport {
+    bool active = false;
+    std::string trace_path;
+    ~ProfileReport() {
+#ifndef ARCHLOG_NO_PROFILE
+        if (active) {
+            AllocStats::Snapshot allocs = AllocStats::snapshot();
+            Profiler::print_summary(allocs.allocations, allocs.bytes);
+        }
+        if (!trace_path.empty()) {
+            Tracer::write_chrome_trace(trace_path);
+        }
+#endif
+    }
+};
+
 int main(int argc, char* argv[]) {
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
+    ProfileReport profile_report;
+    MetricsEndpoint metrics_endpoint;
+#ifndef ARCHLOG_NO_PROFILE
+    AllocStats::set_enabled(false);
+#endif
     
     try {
         SystemCompat::validate_environment();
@@ -46,13 +360,20 @@ int main(int argc, char* argv[]) {
         
         std::string log_level = "";
         std::string service_name = "";
+        std::string log_file = "/var/log/syslog";
         int tail_count = 50;
         bool show_summary = false;
-        bool csv_output = false;
+        OutputFormat output_format = OutputFormat::TEXT;
         bool no_filter = false;
         bool show_journal = false;
         bool show_boot = false;
         bool show_all_logs = false;
+        std::vector<HistoryMetric> history_metrics;
+        int64_t history_window = 3600;
+        bool show_unit_resources = false;
+        bool show_correlation = false;
+        std::string replay_path;
+        double replay_speed = 1.0;
         
         if (argc > 20) {
             throw ArchLogError("Too many arguments", ErrorLevel::ERROR);
@@ -79,7 +400,9 @@ int main(int argc, char* argv[]) {
                     throw ArchLogError("Invalid tail count: " + arg, ErrorLevel::ERROR);
                 }
             } else if (arg == "--csv") {
-                csv_output = true;
+                output_format = OutputFormat::CSV;
+            } else if (arg == "--ndjson") {
+                output_format = OutputFormat::NDJSON;
             } else if (arg == "--no-filter") {
                 no_filter = true;
             } else if (arg == "--journal") {
@@ -90,68 +413,199 @@ int main(int argc, char* argv[]) {
                 show_boot = true;
             } else if (arg == "--all-logs") {
                 show_all_logs = true;
+            } else if (arg.find("--file=") == 0) {
+                log_file = arg.substr(7);
+            } else if (arg == "--profile") {
+#ifndef ARCHLOG_NO_PROFILE
+                if (!profile_report.active) {
+                    profile_report.active = true;
+                    AllocStats::set_enabled(true);
+                    Profiler::enable();
+                }
+#else
+                ErrorHandler::log_error("Profiling support was compiled out", ErrorLevel::WARNING);
+#endif
+            } else if (arg.find("--history=") == 0) {
+                std::string list = arg.substr(10);
+                for (size_t start = 0; start <= list.size();) {
+                    size_t comma = std::min(list.find(',', start), list.size());
+                    HistoryMetric metric;
+                    if (!StatsHistory::parse_metric(list.substr(start, comma - start), metric)) {
+                        throw ArchLogError("Unknown history metric in: " + arg, ErrorLevel::ERROR);
+                    }
+                    history_metrics.push_back(metric);
+                    start = comma + 1;
+                }
+            } else if (arg.find("--window=") == 0) {
+                history_window = StatsHistory::parse_window(arg.substr(9));
+                if (history_window <= 0) {
+                    throw ArchLogError("Invalid history window: " + arg, ErrorLevel::ERROR);
+                }
+            } else if (arg.find("--record=") == 0) {
+                if (!Recorder::shared().open(arg.substr(9))) {
+                    throw ArchLogError("Cannot record to: " + arg.substr(9), ErrorLevel::ERROR);
+                }
+            } else if (arg.find("--replay=") == 0) {
+                replay_path = arg.substr(9);
+            } else if (arg.find("--speed=") == 0) {
+                replay_speed = ReplayClock::parse_speed(arg.substr(8));
+                if (replay_speed < 0.0) {
+                    throw ArchLogError("Invalid replay speed: " + arg, ErrorLevel::ERROR);
+                }
+            } else if (arg == "--correlate") {
+                show_correlation = true;
+            } else if (arg == "--unit-resources") {
+                show_unit_resources = true;
+            } else if (arg.find("--metrics=") == 0) {
+                if (!metrics_endpoint.start(arg.substr(10))) {
+                    throw ArchLogError("Cannot start metrics endpoint: " + arg.substr(10), ErrorLevel::ERROR);
+                }
+            } else if (arg.find("--trace-out=") == 0) {
+#ifndef ARCHLOG_NO_PROFILE
+                profile_report.trace_path = arg.substr(12);
+                if (profile_report.trace_path.empty()) {
+                    throw ArchLogError("Missing trace output path", ErrorLevel::ERROR);
+                }
+                Tracer::enable();
+                Tracer::set_thread_name("archlog");
+#else
+                ErrorHandler::log_error("Tracing support was compiled out", ErrorLevel::WARNING);
+#endif
             } else {
                 throw ArchLogError("Unknown argument: " + arg, ErrorLevel::ERROR);
             }
         }
         
+        if (!history_metrics.empty()) {
+            return print_history(history_metrics, history_window, output_format);
+        }
+        if (!replay_path.empty()) {
+            std::string level = no_filter ? "" : log_level;
+            switch (output_format) {
+                case OutputFormat::CSV: return replay_recording<CsvFormat>(replay_path, replay_speed, false, level);
+                case OutputFormat::NDJSON: return replay_recording<NdjsonFormat>(replay_path, replay_speed, false, level);
+                default: return replay_recording<TextFormat>(replay_path, replay_speed, show_summary, level);
+            }
+        }
+        if (show_correlation) {
+            return print_correlation(history_window, output_format);
+        }
+        if (show_unit_resources) {
+            return print_unit_resources(history_window, output_format);
+        }
+        
         if (show_summary && !interrupted) {
             std::cout << "=== System Hardware Summary ===\n";
             std::cout << "System: " << SystemCompat::get_system_info() << "\n";
             try {
-                HardwareStats stats = HardwareMonitor::get_current_stats();
+                HardwareStats stats;
+                {
+                    ARCHLOG_PROFILE_SCOPE(ProfileStage::HARDWARE);
+                    stats = HardwareMonitor::get_current_stats();
+                }
+                Recorder::shared().record_sample(stats);
                 std::cout << "CPU: " << stats.cpu_name << " (" << stats.cpu_usage << "% usage, " << stats.cpu_temp << "°C)\n";
+                for (const auto& core : stats.cpu_cores) {
+                    std::cout << "  cpu" << core.core << ": " << core.usage << "% (user " << core.user
+                              << "%, system " << core.system << "%, iowait " << core.iowait
+                              << "%, steal " << core.steal << "%)\n";
+                }
                 std::cout << "Memory: " << stats.memory_usage << "% used\n";
-                std::cout << "Disk: " << stats.disk_usage << "% used\n";
+                std::cout << "Disk: " << stats.disk_usage << "% used, read " << stats.disk_read << " KB/s, write "
+                          << stats.disk_write << " KB/s\n";
+                for (const auto& mount : stats.mounts) {
+                    std::cout << "  " << mount.mount_point << " (" << mount.fstype << " on " << mount.source << "): ";
+                    if (mount.timed_out) std::cout << "not responding, last seen ";
+                    std::cout << mount.usage << "% of " << mount.total_bytes / (1024.0 * 1024.0 * 1024.0) << " GiB, inodes "
+                              << mount.inode_usage << "%\n";
+                }
+                for (const auto& device : stats.disk_devices) {
+                    std::cout << "  " << device.name << ": read " << device.read_bytes_per_sec / 1024.0 << " KB/s ("
+                              << device.read_iops << " IOPS), write " << device.write_bytes_per_sec / 1024.0 << " KB/s ("
+                              << device.write_iops << " IOPS), await " << device.await_ms << " ms, "
+                              << device.utilization << "% busy\n";
+                }
                 std::cout << "GPU: " << stats.gpu_name << " (" << stats.gpu_usage << "% usage, " << stats.gpu_temp << "°C)\n";
+                const auto& gpus = InventoryProbe::get().gpus;
+                for (size_t i = 0; gpus.size() > 1 && i < gpus.size(); i++) {
+                    std::cout << "  " << gpus[i].pci_address << ": " << gpus[i].name << " ("
+                              << (gpus[i].driver.empty() ? "no driver" : gpus[i].driver) << ")\n";
+                }
+                for (const auto& gpu : stats.nvidia_gpus) {
+                    std::cout << "  NVIDIA GPU " << gpu.index << ": " << gpu.utilization << "% usage, " << gpu.temperature
+                              << "°C, " << gpu.memory_used_mb << "/" << gpu.memory_total_mb << " MiB, "
+                              << gpu.power_watts << " W\n";
+                }
                 std::cout << "System Load: " << stats.system_load << "\n";
+                if (stats.pressure.available) {
+                    std::cout << "Pressure stalls:\n";
+                    print_pressure_line("cpu", stats.pressure.cpu);
+                    print_pressure_line("memory", stats.pressure.memory);
+                    print_pressure_line("io", stats.pressure.io);
+                }
+                if (!stats.temperatures.empty()) std::cout << "Temperatures:\n";
+                for (const auto& reading : stats.temperatures) {
+                    if (!reading.valid) continue;
+                    std::cout << "  " << reading.label << " [" << SensorRegistry::kind_name(reading.kind) << "]: "
+                              << reading.celsius << "°C\n";
+                }
                 std::cout << "Network: RX " << stats.network_rx << " KB/s, TX " << stats.network_tx << " KB/s\n";
+                for (const auto& interface : stats.network_interfaces) {
+                    std::cout << "  " << interface.name << ": RX " << interface.rx_bytes_per_sec / 1024.0
+                              << " KB/s, TX " << interface.tx_bytes_per_sec / 1024.0 << " KB/s, "
+                              << interface.rx_packets_per_sec + interface.tx_packets_per_sec << " packets/s, "
+                              << interface.rx_errors_per_sec + interface.tx_errors_per_sec << " errors/s\n";
+                }
             } catch (const std::exception& e) {
                 ErrorHandler::log_error("Failed to get hardware stats: " + std::string(e.what()), ErrorLevel::ERROR);
                 return 1;
             }
         }
         
-        // Analyze system logs
-        std::cout << "\n=== System Log Analysis ===\n";
+        // Analyze system logs; machine-readable formats get no banners
+        bool text_output = output_format == OutputFormat::TEXT;
+        if (text_output) std::cout << "\n=== System Log Analysis ===\n";
         try {
             std::vector<LogEntry> logs;
+            std::string source_banner;
             
             if (show_all_logs) {
                 logs = ArchLogManager::get_all_logs(tail_count);
-                std::cout << "Showing all available Arch logs:\n";
+                source_banner = "Showing all available Arch logs:\n";
             } else if (show_journal) {
                 logs = ArchLogManager::get_journal_logs(tail_count);
-                std::cout << "Showing systemd journal logs:\n";
+                source_banner = "Showing systemd journal logs:\n";
             } else if (!service_name.empty()) {
                 logs = ArchLogManager::get_service_logs(service_name, tail_count);
-                std::cout << "Showing logs for service: " << service_name << "\n";
+                source_banner = "Showing logs for service: " + service_name + "\n";
             } else if (show_boot) {
                 logs = ArchLogManager::get_boot_logs();
-                std::cout << "Showing boot logs:\n";
+                source_banner = "Showing boot logs:\n";
             } else {
-                logs = LogAnalyzer::parse_logs("/var/log/syslog", tail_count);
-                std::cout << "Showing syslog entries:\n";
+                logs = LogAnalyzer::parse_logs(log_file, tail_count);
+                source_banner = "Showing syslog entries:\n";
             }
             
+            Recorder::shared().record_logs(logs);
             if (!no_filter && !log_level.empty()) {
                 logs = LogAnalyzer::filter_by_level(logs, log_level);
             }
             
-            if (csv_output) {
-                std::cout << "Timestamp,Level,Service,Message\n";
-                for (const auto& entry : logs) {
-                    std::cout << entry.timestamp << "," << entry.level << "," 
-                             << entry.service << ",\"" << entry.message << "\"\n";
-                }
-            } else {
-                for (const auto& entry : logs) {
-                    std::cout << "[" << entry.timestamp << "] " << entry.level 
-                             << " " << entry.service << ": " << entry.message << "\n";
+            if (text_output) std::cout << source_banner;
+            std::cout.flush(); // Keep ordering with the raw fd writes below
+            
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::OUTPUT);
+                OutputBuffer out(STDOUT_FILENO);
+                switch (output_format) {
+                    case OutputFormat::CSV: OutputSink<CsvFormat>::write(out, logs); break;
+                    case OutputFormat::NDJSON: OutputSink<NdjsonFormat>::write(out, logs); break;
+                    default: OutputSink<TextFormat>::write(out, logs); break;
                 }
             }
+            ARCHLOG_PROFILE_COUNT(ProfileCounter::ENTRIES_EMITTED, logs.size());
             
-            std::cout << "\nTotal entries: " << logs.size() << "\n";
+            if (text_output) std::cout << "\nTotal entries: " << logs.size() << "\n";
             
         } catch (const ArchLogError& e) {
             ErrorHandler::log_error("Log analysis failed: " + std::string(e.what()), e.level());
@@ -0,0 +1,455 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <ctime>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "error_handler.h"
+#include "monotonic_clock.h"
+
+enum class MetricCounter {
+    LINES_JOURNAL,
+    LINES_FILE,
+    LINES_GUI,
+    PARSE_FAILURES_JOURNAL,
+    PARSE_FAILURES_FILE,
+    PARSE_FAILURES_GUI,
+    QUERIES_JOURNAL,
+    QUERIES_FILE,
+    QUERIES_GUI,
+    HARDWARE_SAMPLES,
+    COUNTER_COUNT
+};
+
+enum class MetricGauge {
+    UI_QUEUE_DEPTH,
+    GUI_WORKERS,
+    GAUGE_COUNT
+};
+
+enum class MetricHistogram {
+    HARDWARE_SAMPLE_SECONDS,
+    QUERY_SECONDS,
+    HISTOGRAM_COUNT
+};
+
+// Process-wide metrics for the Prometheus endpoint. Counters and histograms
+// live in per-thread slots written without locked instructions and summed on
+// scrape; gauges move up and down from different threads and are plain atomics.
+class Metrics {
+public:
+    static constexpr int COUNTERS = static_cast<int>(MetricCounter::COUNTER_COUNT);
+    static constexpr int GAUGES = static_cast<int>(MetricGauge::GAUGE_COUNT);
+    static constexpr int HISTOGRAMS = static_cast<int>(MetricHistogram::HISTOGRAM_COUNT);
+    static constexpr int BUCKETS = 14; // Last bucket is +Inf
+
+    static void add(MetricCounter counter, uint64_t n = 1) {
+        Slot* slot = local_slot();
+        bump(slot, slot->counters[static_cast<int>(counter)], n);
+    }
+
+    static void gauge_add(MetricGauge gauge, int64_t delta) {
+        gauges_[static_cast<int>(gauge)].fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    static void observe_ns(MetricHistogram histogram, uint64_t ns) {
+        Slot* slot = local_slot();
+        int index = static_cast<int>(histogram);
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && ns > bucket_bounds_ns()[bucket]) bucket++;
+        bump(slot, slot->buckets[index][bucket], 1);
+        bump(slot, slot->sum_ns[index], ns);
+    }
+
+    static uint64_t now_ns() { return MonotonicClock::now_ns(); }
+
+    // Prometheus text exposition format 0.0.4
+    static std::string scrape() {
+        uint64_t counters[COUNTERS] = {};
+        uint64_t buckets[HISTOGRAMS][BUCKETS] = {};
+        uint64_t sums[HISTOGRAMS] = {};
+        {
+            std::lock_guard<std::mutex> lock(slots_mutex_);
+            accumulate(retired_, counters, buckets, sums);
+            accumulate(overflow_, counters, buckets, sums);
+            for (size_t i = 0; i < slots_used_; i++) {
+                if (slots_[i].in_use) accumulate(slots_[i], counters, buckets, sums);
+            }
+        }
+
+        static const char* counter_lines[] = {
+            "archlog_lines_ingested_total{source=\"journal\"}",
+            "archlog_lines_ingested_total{source=\"file\"}",
+            "archlog_lines_ingested_total{source=\"gui\"}",
+            "archlog_parse_failures_total{source=\"journal\"}",
+            "archlog_parse_failures_total{source=\"file\"}",
+            "archlog_parse_failures_total{source=\"gui\"}",
+            "archlog_queries_total{source=\"journal\"}",
+            "archlog_queries_total{source=\"file\"}",
+            "archlog_queries_total{source=\"gui\"}",
+            "archlog_hardware_samples_total",
+        };
+        static const char* gauge_names[] = {"archlog_ui_queue_depth", "archlog_gui_workers"};
+        static const char* gauge_help[] = {
+            "Worker results waiting for the GTK main loop.",
+            "GUI worker threads currently running.",
+        };
+        static const char* histogram_names[] = {"archlog_hardware_sample_seconds", "archlog_query_seconds"};
+        static const char* histogram_help[] = {
+            "Time to collect one hardware sample.",
+            "Time to fetch and parse the entries for one log query.",
+        };
+
+        std::string out;
+        out.reserve(4096);
+        out += "# HELP archlog_lines_ingested_total Log lines read from each source.\n";
+        out += "# TYPE archlog_lines_ingested_total counter\n";
+        for (int i = 0; i < COUNTERS; i++) {
+            if (i == static_cast<int>(MetricCounter::PARSE_FAILURES_JOURNAL)) {
+                out += "# HELP archlog_parse_failures_total Lines that could not be parsed.\n";
+                out += "# TYPE archlog_parse_failures_total counter\n";
+            } else if (i == static_cast<int>(MetricCounter::QUERIES_JOURNAL)) {
+                out += "# HELP archlog_queries_total Log queries completed.\n";
+                out += "# TYPE archlog_queries_total counter\n";
+            } else if (i == static_cast<int>(MetricCounter::HARDWARE_SAMPLES)) {
+                out += "# HELP archlog_hardware_samples_total Hardware samples collected.\n";
+                out += "# TYPE archlog_hardware_samples_total counter\n";
+            }
+            out += counter_lines[i];
+            out += ' ';
+            out += std::to_string(counters[i]);
+            out += '\n';
+        }
+
+        for (int i = 0; i < GAUGES; i++) {
+            out += std::string("# HELP ") + gauge_names[i] + " " + gauge_help[i] + "\n";
+            out += std::string("# TYPE ") + gauge_names[i] + " gauge\n";
+            out += std::string(gauge_names[i]) + " " + std::to_string(gauges_[i].load(std::memory_order_relaxed)) + "\n";
+        }
+
+        for (int h = 0; h < HISTOGRAMS; h++) {
+            std::string name = histogram_names[h];
+            out += "# HELP " + name + " " + histogram_help[h] + "\n";
+            out += "# TYPE " + name + " histogram\n";
+            uint64_t cumulative = 0;
+            char line[160];
+            for (int b = 0; b < BUCKETS; b++) {
+                cumulative += buckets[h][b];
+                if (b < BUCKETS - 1) {
+                    std::snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %llu\n", name.c_str(),
+                                  bucket_bounds_ns()[b] / 1e9, static_cast<unsigned long long>(cumulative));
+                } else {
+                    std::snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n", name.c_str(),
+                                  static_cast<unsigned long long>(cumulative));
+                }
+                out += line;
+            }
+            std::snprintf(line, sizeof(line), "%s_sum %.9f\n%s_count %llu\n", name.c_str(), sums[h] / 1e9,
+                          name.c_str(), static_cast<unsigned long long>(cumulative));
+            out += line;
+        }
+        return out;
+    }
+
+private:
+    static constexpr size_t MAX_THREADS = 64;
+
+    struct Slot {
+        std::atomic<uint64_t> counters[COUNTERS];
+        std::atomic<uint64_t> buckets[HISTOGRAMS][BUCKETS];
+        std::atomic<uint64_t> sum_ns[HISTOGRAMS];
+        bool in_use = false;
+        bool shared = false;
+        size_t next_free = 0;
+    };
+
+    // Returns the calling thread's slot to the free list when the thread exits,
+    // folding its totals into retired_ so counters never go backwards
+    struct SlotHandle {
+        Slot* slot = nullptr;
+        ~SlotHandle() {
+            if (!slot || slot->shared) return;
+            std::lock_guard<std::mutex> lock(slots_mutex_);
+            for (int i = 0; i < COUNTERS; i++) move_into(retired_.counters[i], slot->counters[i]);
+            for (int h = 0; h < HISTOGRAMS; h++) {
+                for (int b = 0; b < BUCKETS; b++) move_into(retired_.buckets[h][b], slot->buckets[h][b]);
+                move_into(retired_.sum_ns[h], slot->sum_ns[h]);
+            }
+            slot->in_use = false;
+            slot->next_free = free_head_;
+            free_head_ = static_cast<size_t>(slot - slots_) + 1;
+            slot = nullptr;
+            exited_ = true;
+        }
+    };
+
+    static const uint64_t* bucket_bounds_ns() {
+        static const uint64_t bounds[BUCKETS - 1] = {
+            10000, 50000, 100000, 500000, 1000000, 5000000, 10000000,
+            50000000, 100000000, 500000000, 1000000000, 5000000000ULL, 10000000000ULL};
+        return bounds;
+    }
+
+    // Single writer per slot, so load + store is enough; the shared overflow
+    // slot used past MAX_THREADS falls back to an atomic add
+    static void bump(const Slot* slot, std::atomic<uint64_t>& value, uint64_t n) {
+        if (slot->shared) {
+            value.fetch_add(n, std::memory_order_relaxed);
+        } else {
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    }
+
+    static void move_into(std::atomic<uint64_t>& to, std::atomic<uint64_t>& from) {
+        to.fetch_add(from.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    static Slot* local_slot() {
+        if (local_handle_.slot) return local_handle_.slot;
+
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+        Slot* slot;
+        if (exited_) {
+            // Recording from a later thread_local destructor: its handle is
+            // gone, so a private slot would never be returned
+            overflow_.shared = true;
+            return &overflow_;
+        }
+        if (free_head_ != 0) {
+            slot = &slots_[free_head_ - 1];
+            free_head_ = slot->next_free;
+        } else if (slots_used_ < MAX_THREADS) {
+            slot = &slots_[slots_used_++];
+        } else {
+            slot = &overflow_;
+            slot->shared = true;
+        }
+        slot->in_use = true;
+        local_handle_.slot = slot;
+        return slot;
+    }
+
+    static void accumulate(const Slot& slot, uint64_t* counters, uint64_t (*buckets)[BUCKETS], uint64_t* sums) {
+        for (int i = 0; i < COUNTERS; i++) counters[i] += slot.counters[i].load(std::memory_order_relaxed);
+        for (int h = 0; h < HISTOGRAMS; h++) {
+            for (int b = 0; b < BUCKETS; b++) buckets[h][b] += slot.buckets[h][b].load(std::memory_order_relaxed);
+            sums[h] += slot.sum_ns[h].load(std::memory_order_relaxed);
+        }
+    }
+
+    static std::atomic<int64_t> gauges_[GAUGES];
+    static std::mutex slots_mutex_;
+    static Slot slots_[MAX_THREADS];
+    static size_t slots_used_;
+    static size_t free_head_; // 1-based index into slots_, 0 when empty
+    static Slot retired_;
+    static Slot overflow_;
+    static thread_local SlotHandle local_handle_;
+    static thread_local bool exited_;
+
+    friend class MetricsServer;
+};
+
+// Times a scope into a histogram
+class MetricsTimer {
+public:
+    explicit MetricsTimer(MetricHistogram histogram) : histogram_(histogram), start_(Metrics::now_ns()) {}
+    ~MetricsTimer() { Metrics::observe_ns(histogram_, Metrics::now_ns() - start_); }
+
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+private:
+    MetricHistogram histogram_;
+    uint64_t start_;
+};
+
+// Serves GET /metrics over HTTP/1.0 on a Unix socket ("unix:/path") or a
+// loopback TCP port ("9464" or "127.0.0.1:9464"), from one background thread.
+class MetricsServer {
+public:
+    static bool start(const std::string& address) {
+        if (listen_fd_ >= 0) return true;
+
+        int fd = address.find("unix:") == 0 ? listen_unix(address.substr(5)) : listen_loopback(address);
+        if (fd < 0) return false;
+
+        listen_fd_ = fd;
+        running_.store(true);
+        thread_ = std::thread(serve);
+        return true;
+    }
+
+    static void stop() {
+        if (listen_fd_ < 0) return;
+        running_.store(false);
+        if (thread_.joinable()) thread_.join();
+        close(listen_fd_);
+        listen_fd_ = -1;
+        if (!unix_path_.empty()) {
+            unlink(unix_path_.c_str());
+            unix_path_.clear();
+        }
+    }
+
+private:
+    static int listen_unix(const std::string& path) {
+        struct sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            ErrorHandler::log_error("Invalid metrics socket path: " + path, ErrorLevel::ERROR);
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        // Replace a stale socket from an earlier run, but never a regular file
+        struct stat st;
+        if (lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path.c_str());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            ErrorHandler::handle_system_error("metrics socket", errno);
+            return -1;
+        }
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+            ErrorHandler::handle_system_error("metrics bind " + path, errno);
+            close(fd);
+            return -1;
+        }
+        chmod(path.c_str(), 0600);
+        unix_path_ = path;
+        return fd;
+    }
+
+    static int listen_loopback(const std::string& address) {
+        std::string host = "127.0.0.1";
+        std::string port = address;
+        size_t colon = address.rfind(':');
+        if (colon != std::string::npos) {
+            host = address.substr(0, colon);
+            port = address.substr(colon + 1);
+        }
+        if (host == "localhost") host = "127.0.0.1";
+        if (host != "127.0.0.1") {
+            ErrorHandler::log_error("Metrics endpoint only binds to loopback, got: " + address, ErrorLevel::ERROR);
+            return -1;
+        }
+        if (port.empty() || port.size() > 5 || port.find_first_not_of("0123456789") != std::string::npos ||
+            std::stoi(port) == 0 || std::stoi(port) > 65535) {
+            ErrorHandler::log_error("Invalid metrics port: " + address, ErrorLevel::ERROR);
+            return -1;
+        }
+
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            ErrorHandler::handle_system_error("metrics socket", errno);
+            return -1;
+        }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+            ErrorHandler::handle_system_error("metrics bind " + address, errno);
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static void serve() {
+        while (running_.load()) {
+            struct pollfd pfd = {listen_fd_, POLLIN, 0};
+            int ready = poll(&pfd, 1, 200);
+            if (ready <= 0) continue;
+
+            int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) continue;
+            handle_client(client);
+            close(client);
+        }
+    }
+
+    static void handle_client(int client) {
+        struct timeval timeout = {1, 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        char request[2048];
+        size_t length = 0;
+        while (length < sizeof(request) - 1) {
+            ssize_t n = recv(client, request + length, sizeof(request) - 1 - length, 0);
+            if (n <= 0) break;
+            length += static_cast<size_t>(n);
+            request[length] = '\0';
+            if (std::strstr(request, "\r\n\r\n") || std::strstr(request, "\n\n")) break;
+        }
+        request[length] = '\0';
+
+        std::string response;
+        if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+            std::string body = Metrics::scrape();
+            response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                       std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        } else {
+            response = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        }
+
+        const char* data = response.data();
+        size_t remaining = response.size();
+        while (remaining > 0) {
+            ssize_t n = send(client, data, remaining, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            data += n;
+            remaining -= static_cast<size_t>(n);
+        }
+    }
+
+    static int listen_fd_;
+    static std::string unix_path_;
+    static std::atomic<bool> running_;
+    static std::thread thread_;
+};
+
+// Stops the endpoint however main() returns
+struct MetricsEndpoint {
+    bool start(const std::string& address) { return MetricsServer::start(address); }
+    ~MetricsEndpoint() { MetricsServer::stop(); }
+};
+
+// Static member definitions
+std::atomic<int64_t> Metrics::gauges_[Metrics::GAUGES];
+std::mutex Metrics::slots_mutex_;
+Metrics::Slot Metrics::slots_[Metrics::MAX_THREADS];
+size_t Metrics::slots_used_ = 0;
+size_t Metrics::free_head_ = 0;
+Metrics::Slot Metrics::retired_;
+Metrics::Slot Metrics::overflow_;
+thread_local Metrics::SlotHandle Metrics::local_handle_;
+thread_local bool Metrics::exited_ = false;
+
+int MetricsServer::listen_fd_ = -1;
+std::string MetricsServer::unix_path_;
+std::atomic<bool> MetricsServer::running_{false};
+std::thread MetricsServer::thread_;
+
+#endif
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <cstdio>
 #include <thread>
 #include <mutex>
@@ -10,12 +11,20 @@
 #include <memory>
 #include <chrono>
 #include <cstdlib>
+#include <pwd.h>
 #include "security.h"
 #include "arch_features.h"
 #include "enhanced_security.h"
 #include "quick_actions.h"
 #include "hardware_monitor.h"
+#include "collector_scheduler.h"
 #include "structured_logger.h"
+#include "journal_formatter.h"
+#include "profiler.h"
+#include "metrics.h"
+#include "stats_history.h"
+#include "process_stats.h"
+#include "recording.h"
 
 class ModernArchLogGUI {
 private:
@@ -44,11 +53,25 @@ private:
     GtkWidget *network_label;
     std::mutex buffer_mutex;
     std::atomic<bool> is_running{false};
-    std::atomic<bool> monitor_running{false};
+    CollectorScheduler hardware_scheduler;
+    std::thread hardware_thread; // Joined on destruction, after the scheduler is stopped
+    HardwareStats last_stats; // Latest sample shown, main thread only
+    std::string replay_path;  // Hardware panel and log view driven by a recording instead of live sources
+    double replay_speed;
+    std::atomic<bool> replay_running{true};
+    std::thread replay_thread;
+    ProcessCollector process_collector; // Shared by the process workers; tables reused across clicks
+    std::mutex process_mutex;
+    struct Worker {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+    std::vector<Worker> workers; // Button-started workers, main thread only; joined on destruction
     bool initialized{false};
 
 public:
-    ModernArchLogGUI() {
+    explicit ModernArchLogGUI(std::string replay = "", double speed = 1.0)
+        : replay_path(std::move(replay)), replay_speed(speed) {
         StructuredLogger::initialize();
         StructuredLogger::user_action("GUI Initialization Started");
         
@@ -61,11 +84,11 @@ public:
             if (!getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY")) {
                 setenv("DISPLAY", ":0", 0);
                 if (!gtk_init_check(&argc, &argv)) {
-                    StructuredLogger::error("gui_init", "/gui", "GTK initialization failed - running in headless mode");
+                    ARCHLOG_ERROR("gui_init", "/gui", "GTK initialization failed - running in headless mode");
                     return; // Don't throw, just return
                 }
             } else {
-                StructuredLogger::error("gui_init", "/gui", "GTK initialization failed");
+                ARCHLOG_ERROR("gui_init", "/gui", "GTK initialization failed");
                 return;
             }
         }
@@ -79,14 +102,23 @@ public:
             gtk_widget_show_all(window);
             refresh_units();
             
-            StructuredLogger::info("gui_init", "/gui", "GUI initialized successfully with dark theme");
+            ARCHLOG_INFO("gui_init", "/gui", "GUI initialized successfully with dark theme");
             initialized = true;
         } catch (const std::exception& e) {
-            StructuredLogger::error("gui_init", "/gui", std::string("GUI setup failed: ") + e.what());
+            ARCHLOG_ERROR("gui_init", "/gui", "GUI setup failed: {}", e.what());
             initialized = false;
         }
     }
     
+    // The workers capture this; stop them and wait before members go away
+    ~ModernArchLogGUI() {
+        hardware_scheduler.stop();
+        replay_running.store(false);
+        if (hardware_thread.joinable()) hardware_thread.join();
+        if (replay_thread.joinable()) replay_thread.join();
+        for (auto& worker : workers) worker.thread.join();
+    }
+
     bool is_initialized() const { return initialized; }
 
     void create_window() {
@@ -504,28 +536,117 @@ public:
     }
     
     void start_hardware_monitoring() {
-        monitor_running.store(true);
-        std::thread([this]() {
-            while (monitor_running.load()) {
-                auto stats = HardwareMonitor::get_current_stats();
-                
-                g_idle_add([](gpointer data) -> gboolean {
-                    auto pair = static_cast<std::pair<ModernArchLogGUI*, HardwareStats>*>(data);
-                    pair->first->update_hardware_display(pair->second);
-                    delete pair;
-                    return G_SOURCE_REMOVE;
-                }, new std::pair<ModernArchLogGUI*, HardwareStats>(this, stats));
-                
-                std::this_thread::sleep_for(std::chrono::seconds(2));
+        if (!replay_path.empty()) {
+            start_replay();
+            return;
+        }
+        hardware_thread = std::thread([this]() {
+            using std::chrono::milliseconds;
+            using std::chrono::microseconds;
+            Tracer::set_thread_name("hardware monitor");
+            WorkerGauge worker_gauge;
+            HardwareSampler sampler;
+            HardwareStats stats;
+
+            // Fast-moving figures often, slow or expensive probes rarely; budgets
+            // are generous for sysfs/proc reads, so only stalls (nvidia-smi, a hung
+            // network mount under /) trigger backoff
+            CollectorScheduler& scheduler = hardware_scheduler;
+            scheduler.add("cpu", milliseconds(1000), microseconds(2000), [&] { sampler.sample_cpu(stats); });
+            scheduler.add("network", milliseconds(1000), microseconds(2000), [&] { sampler.sample_network(stats); });
+            scheduler.add("memory", milliseconds(2000), microseconds(1000), [&] { sampler.sample_memory(stats); });
+            scheduler.add("load", milliseconds(2000), microseconds(1000), [&] { sampler.sample_load(stats); });
+            scheduler.add("pressure", milliseconds(2000), microseconds(1000), [&] { sampler.sample_pressure(stats); });
+            scheduler.add("units", milliseconds(5000), microseconds(5000), [&] { sampler.sample_units(stats); });
+            scheduler.add("temperatures", milliseconds(2000), microseconds(5000), [&] { sampler.sample_temperatures(stats); });
+            scheduler.add("gpu", milliseconds(2000), microseconds(5000), [&] { sampler.sample_gpu(stats); });
+            scheduler.add("connections", milliseconds(5000), microseconds(5000), [&] { sampler.sample_connections(stats); });
+            scheduler.add("disk", milliseconds(10000), microseconds(5000), [&] { sampler.sample_disk(stats); });
+            scheduler.add("disk io", milliseconds(2000), microseconds(1000), [&] { sampler.sample_disk_io(stats); });
+            scheduler.add("inventory", milliseconds(0), microseconds(1000), [&] { sampler.sample_names(stats); });
+
+            unsigned batches = 0;
+            scheduler.run([&](uint64_t batch_ns) {
+                Metrics::add(MetricCounter::HARDWARE_SAMPLES);
+                Metrics::observe_ns(MetricHistogram::HARDWARE_SAMPLE_SECONDS, batch_ns);
+                StatsHistory::shared().record(static_cast<int64_t>(time(nullptr)), stats);
+                if (++batches % HISTORY_SAVE_BATCHES == 0) save_history();
+                Recorder::shared().record_sample(stats);
+                post_stats(stats);
+            });
+        });
+    }
+
+    // Plays a --replay recording into the hardware panel and the log view at
+    // its recorded pace; nothing replayed enters the live history
+    void start_replay() {
+        replay_thread = std::thread([this]() {
+            Tracer::set_thread_name("replay");
+            WorkerGauge worker_gauge;
+            Replayer replayer;
+            if (!replayer.open(replay_path)) {
+                post_status("Error: Cannot replay " + replay_path);
+                return;
             }
-        }).detach();
+            post_status("⏯️ Replaying " + replay_path);
+            ReplayClock clock(replay_speed, &replay_running);
+            ReplayEvent event;
+            size_t entries = 0;
+            while (replay_running.load() && replayer.next(event)) {
+                clock.wait(event);
+                if (event.kind == ReplayEvent::SAMPLE) {
+                    post_stats(event.stats);
+                    continue;
+                }
+                std::string text;
+                for (const auto& entry : event.logs) {
+                    text += "[" + std::to_string(entries++) + "] [" + entry.timestamp + "] [" + entry.level +
+                            "] [REPLAY] " + entry.service + " | " + entry.message + "\n";
+                }
+                post_text(std::make_shared<std::string>(std::move(text)));
+            }
+            post_status("✅ Replay finished - " + std::to_string(entries) + " log entries");
+        });
+    }
+
+    void post_stats(const HardwareStats& stats) {
+        struct PendingStats { ModernArchLogGUI* gui; HardwareStats stats; uint64_t queued_ns; };
+        Metrics::gauge_add(MetricGauge::UI_QUEUE_DEPTH, 1); // Before the callback can run and decrement
+        g_idle_add([](gpointer data) -> gboolean {
+            auto pending = static_cast<PendingStats*>(data);
+            Metrics::gauge_add(MetricGauge::UI_QUEUE_DEPTH, -1);
+            Tracer::async("ui queue wait", "ui", pending->queued_ns, Tracer::now_ns());
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::UI_APPEND);
+                pending->gui->update_hardware_display(pending->stats);
+            }
+            delete pending;
+            return G_SOURCE_REMOVE;
+        }, new PendingStats{this, stats, Tracer::now_ns()});
     }
     
+    // Persisted every HISTORY_SAVE_BATCHES scheduler wakeups (about a minute) and at exit
+    static constexpr unsigned HISTORY_SAVE_BATCHES = 60;
+
+    static void save_history() {
+        std::string path = StatsHistory::default_path();
+        if (!path.empty()) StatsHistory::shared().save(path);
+    }
+
     void update_hardware_display(const HardwareStats& stats) {
+        last_stats = stats;
+        
         // Update CPU
         gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(cpu_progress), stats.cpu_usage / 100.0);
         gtk_progress_bar_set_text(GTK_PROGRESS_BAR(cpu_progress), 
                                  (std::to_string((int)stats.cpu_usage) + "%").c_str());
+        std::string cores;
+        for (const auto& core : stats.cpu_cores) {
+            if (!cores.empty()) cores += "\n";
+            cores += "cpu" + std::to_string(core.core) + ": " + std::to_string((int)core.usage) + "% (iowait " +
+                     std::to_string((int)core.iowait) + "%, steal " + std::to_string((int)core.steal) + "%)";
+        }
+        gtk_widget_set_tooltip_text(cpu_progress, cores.c_str());
         
         // Update Memory
         gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(memory_progress), stats.memory_usage / 100.0);
@@ -536,28 +657,67 @@ public:
         gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(disk_progress), stats.disk_usage / 100.0);
         gtk_progress_bar_set_text(GTK_PROGRESS_BAR(disk_progress), 
                                  (std::to_string((int)stats.disk_usage) + "%").c_str());
+        std::string disks;
+        for (const auto& mount : stats.mounts) {
+            if (!disks.empty()) disks += "\n";
+            disks += mount.mount_point + ": " + std::to_string((int)mount.usage) + "% used, inodes " +
+                     std::to_string((int)mount.inode_usage) + "%" + (mount.timed_out ? " (not responding)" : "");
+        }
+        for (const auto& device : stats.disk_devices) {
+            if (!disks.empty()) disks += "\n";
+            disks += device.name + ": R " + std::to_string((int)(device.read_bytes_per_sec / 1024.0)) + " W " +
+                     std::to_string((int)(device.write_bytes_per_sec / 1024.0)) + " KB/s, " +
+                     std::to_string((int)device.utilization) + "% busy";
+        }
+        gtk_widget_set_tooltip_text(disk_progress, disks.c_str());
         
         // Update Temperatures
         gtk_label_set_text(GTK_LABEL(cpu_temp_label), 
                           ("CPU: " + std::to_string(stats.cpu_temp) + "°C").c_str());
         gtk_label_set_text(GTK_LABEL(gpu_temp_label), 
                           ("GPU: " + std::to_string(stats.gpu_temp) + "°C").c_str());
+        std::string cpu_sensors, gpu_sensors;
+        for (const auto& reading : stats.temperatures) {
+            if (!reading.valid) continue;
+            std::string& target = reading.kind == SensorKind::GPU ? gpu_sensors : cpu_sensors;
+            if (!target.empty()) target += "\n";
+            target += reading.label + ": " + std::to_string((int)reading.celsius) + "°C";
+        }
+        gtk_widget_set_tooltip_text(cpu_temp_label, cpu_sensors.c_str());
+        gtk_widget_set_tooltip_text(gpu_temp_label, gpu_sensors.c_str());
         
         // Update GPU
         gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(gpu_progress), stats.gpu_usage / 100.0);
         gtk_progress_bar_set_text(GTK_PROGRESS_BAR(gpu_progress), 
                                  (std::to_string((int)stats.gpu_usage) + "%").c_str());
+        std::string nvidia;
+        for (const auto& gpu : stats.nvidia_gpus) {
+            if (!nvidia.empty()) nvidia += "\n";
+            nvidia += "GPU " + std::to_string(gpu.index) + ": " + std::to_string((int)gpu.utilization) + "%, " +
+                      std::to_string(gpu.temperature) + "°C, " + std::to_string((int)gpu.memory_used_mb) + "/" +
+                      std::to_string((int)gpu.memory_total_mb) + " MiB, " + std::to_string((int)gpu.power_watts) + " W";
+        }
+        gtk_widget_set_tooltip_text(gpu_progress, nvidia.empty() ? nullptr : nvidia.c_str());
         
         // Update Network
         gtk_label_set_text(GTK_LABEL(network_label), 
                           ("↓" + std::to_string((int)stats.network_rx) + " ↑" + 
                            std::to_string((int)stats.network_tx) + " KB/s").c_str());
+        std::string interfaces;
+        for (const auto& interface : stats.network_interfaces) {
+            if (!interfaces.empty()) interfaces += "\n";
+            interfaces += interface.name + ": ↓" + std::to_string((int)(interface.rx_bytes_per_sec / 1024.0)) +
+                          " ↑" + std::to_string((int)(interface.tx_bytes_per_sec / 1024.0)) + " KB/s, " +
+                          std::to_string((int)(interface.rx_errors_per_sec + interface.tx_errors_per_sec)) + " errors/s";
+        }
+        gtk_widget_set_tooltip_text(network_label, interfaces.c_str());
         
         // Update System Load
         GtkWidget *hw_box = gtk_widget_get_parent(cpu_progress);
         GtkWidget *load_label = GTK_WIDGET(g_object_get_data(G_OBJECT(hw_box), "load_label"));
         if (load_label) {
             gtk_label_set_text(GTK_LABEL(load_label), ("Load: " + stats.system_load).c_str());
+            gtk_widget_set_tooltip_text(load_label, format_unit_load(stats).c_str());
         }
         
         // Update Connections
@@ -572,7 +732,7 @@ public:
         
         if (is_running.load()) {
             update_status("Analysis already in progress...");
-            StructuredLogger::warn("log_analysis", "/gui", "Analysis already in progress");
+            ARCHLOG_WARN("log_analysis", "/gui", "Analysis already in progress");
             return;
         }
         
@@ -637,10 +797,13 @@ public:
             cmd += " -f";
         }
 
-        StructuredLogger::system("journalctl", "/usr/bin", "Executing: " + cmd);
+        ARCHLOG_LOG(LogLevel::INFO, LogCategory::SYSTEM, "journalctl", "/usr/bin", "Executing: {}", cmd);
         
         // Execute in thread
         std::thread([this, cmd, level, summary, csv, watch]() {
+            Tracer::set_thread_name("journal worker");
+            WorkerGauge worker_gauge;
+            MetricsTimer query_timer(MetricHistogram::QUERY_SECONDS);
             g_idle_add([](gpointer data) -> gboolean {
                 ModernArchLogGUI* gui = static_cast<ModernArchLogGUI*>(data);
                 gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(gui->progress_bar), 0.3);
@@ -649,9 +812,13 @@ public:
                 return G_SOURCE_REMOVE;
             }, this);
 
-            FILE* pipe = popen(cmd.c_str(), "r");
+            FILE* pipe;
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+                pipe = popen(cmd.c_str(), "r");
+            }
             if (!pipe) {
-                StructuredLogger::error("journalctl", "/usr/bin", "Failed to execute command: " + cmd);
+                ARCHLOG_ERROR("journalctl", "/usr/bin", "Failed to execute command: {}", cmd);
                 g_idle_add([](gpointer data) -> gboolean {
                     ModernArchLogGUI* gui = static_cast<ModernArchLogGUI*>(data);
                     gui->append_text("[ERROR] [SYSTEM] journalctl (/usr/bin) | Could not execute journalctl command\n");
@@ -666,39 +833,45 @@ public:
             std::string output;
             int entry_count = 0;
             int max_entries = watch ? 10000 : 1000;
+            bool recording = Recorder::shared().is_open();
+            std::vector<LogEntry> recorded;
             
-            while (fgets(buffer, sizeof(buffer), pipe) != NULL && (!watch || entry_count < max_entries)) {
+            while (!watch || entry_count < max_entries) {
+                {
+                    ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+                    if (fgets(buffer, sizeof(buffer), pipe) == NULL) break;
+                }
                 std::string line(buffer);
+                Metrics::add(MetricCounter::LINES_GUI);
                 
                 if (line.find('{') != std::string::npos) {
                     // Process JSON entry with structured logging
-                    std::string formatted_line = format_log_entry(line, entry_count);
+                    ARCHLOG_PROFILE_SCOPE(ProfileStage::PARSE);
+                    std::string formatted_line = JournalFormatter::format_log_entry(line, entry_count);
                     output += formatted_line;
                     entry_count++;
+                    if (recording) recorded.push_back(JournalFormatter::to_log_entry(line));
+                } else {
+                    Metrics::add(MetricCounter::PARSE_FAILURES_GUI);
                 }
                 
                 if (output.length() > 2000) {
-                    auto output_copy = std::make_shared<std::string>(output);
-                    g_idle_add([](gpointer data) -> gboolean {
-                        auto pair = static_cast<std::pair<ModernArchLogGUI*, std::shared_ptr<std::string>>*>(data);
-                        pair->first->append_text(*(pair->second));
-                        delete pair;
-                        return G_SOURCE_REMOVE;
-                    }, new std::pair<ModernArchLogGUI*, std::shared_ptr<std::string>>(this, output_copy));
+                    post_text(std::make_shared<std::string>(output));
                     output.clear();
+                    Recorder::shared().record_logs(recorded);
+                    recorded.clear();
                 }
             }
-            pclose(pipe);
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::JOURNAL_FETCH);
+                pclose(pipe);
+            }
+            Metrics::add(MetricCounter::QUERIES_GUI);
 
             if (!output.empty()) {
-                auto output_copy = std::make_shared<std::string>(output);
-                g_idle_add([](gpointer data) -> gboolean {
-                    auto pair = static_cast<std::pair<ModernArchLogGUI*, std::shared_ptr<std::string>>*>(data);
-                    pair->first->append_text(*(pair->second));
-                    delete pair;
-                    return G_SOURCE_REMOVE;
-                }, new std::pair<ModernArchLogGUI*, std::shared_ptr<std::string>>(this, output_copy));
+                post_text(std::make_shared<std::string>(output));
             }
+            Recorder::shared().record_logs(recorded);
 
             g_idle_add([](gpointer data) -> gboolean {
                 auto pair = static_cast<std::pair<ModernArchLogGUI*, int>*>(data);
@@ -708,10 +881,10 @@ public:
                 gtk_progress_bar_set_text(GTK_PROGRESS_BAR(gui->progress_bar), "Complete");
                 if (count == 0) {
                     gui->update_status("⚠️ No logs found - try different filters");
-                    StructuredLogger::warn("log_analysis", "/gui", "No logs found with current filters");
+                    ARCHLOG_WARN("log_analysis", "/gui", "No logs found with current filters");
                 } else {
                     gui->update_status("✅ Analysis completed - " + std::to_string(count) + " entries found");
-                    StructuredLogger::info("log_analysis", "/gui", "Analysis completed: " + std::to_string(count) + " entries");
+                    ARCHLOG_INFO("log_analysis", "/gui", "Analysis completed: {} entries", count);
                 }
                 gui->is_running.store(false);
                 delete pair;
@@ -843,64 +1016,108 @@ public:
     }
     
     void show_top_processes() {
-        append_text("\n=== TOP CPU PROCESSES ===\n");
+        append_text("\n=== TOP PROCESSES ===\n");
         update_status("Loading process information...");
         
-        FILE* pipe = popen("ps aux --sort=-%cpu | head -10", "r");
-        if (pipe) {
-            char buffer[256];
-            bool has_output = false;
-            while (fgets(buffer, sizeof(buffer), pipe)) {
-                append_text(std::string(buffer));
-                has_output = true;
-            }
-            pclose(pipe);
-            
-            if (!has_output) {
-                append_text("No process information available.\n");
+        start_worker([this]() {
+            Tracer::set_thread_name("process worker");
+            WorkerGauge worker_gauge;
+            std::vector<ProcessStats> top_cpu, top_memory;
+            std::string text;
+            if (sample_processes(TOP_PROCESSES, top_cpu, top_memory)) {
+                text = "By CPU:\n" + format_processes(top_cpu, "") + "By memory:\n" + format_processes(top_memory, "");
+                post_status("Process information displayed");
+            } else {
+                text = "Error: Could not read /proc.\n";
+                post_status("Error: process information unavailable");
             }
-        } else {
-            append_text("Error: Could not retrieve process information.\n");
-            append_text("The 'ps' command may not be available.\n");
+            post_text(std::make_shared<std::string>(text + "\n"));
+        });
+    }
+    
+    static constexpr size_t TOP_PROCESSES = 10;
+
+    // Top K by CPU and memory over one interval; a baseline older than that
+    // would average CPU since the previous click, so it is taken afresh
+    bool sample_processes(size_t k, std::vector<ProcessStats>& top_cpu, std::vector<ProcessStats>& top_memory) {
+        std::lock_guard<std::mutex> lock(process_mutex);
+        const uint64_t interval_ns = HardwareMonitor::ONE_SHOT_INTERVAL_MS * 1000000ULL;
+        if (!process_collector.has_baseline() || process_collector.baseline_age_ns() > interval_ns) {
+            if (!process_collector.sample(k, top_cpu, top_memory)) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(HardwareMonitor::ONE_SHOT_INTERVAL_MS));
         }
-        append_text("\n");
-        update_status("Process information displayed");
+        return process_collector.sample(k, top_cpu, top_memory);
+    }
+
+    static std::string format_processes(const std::vector<ProcessStats>& processes, const std::string& prefix) {
+        std::string text = prefix + "    PID USER        %CPU  %MEM      RSS S COMMAND\n";
+        for (const auto& process : processes) {
+            char line[160];
+            snprintf(line, sizeof(line), "%7d %-10.10s %5.1f %5.1f %7lluK %c %s\n", process.pid,
+                     user_name(process.uid).c_str(), process.cpu_percent, process.memory_percent,
+                     static_cast<unsigned long long>(process.rss_bytes / 1024), process.state, process.command.c_str());
+            text += prefix + line;
+        }
+        return text;
+    }
+
+    static std::string user_name(unsigned uid) {
+        struct passwd entry, *result = nullptr;
+        char buffer[1024];
+        if (getpwuid_r(uid, &entry, buffer, sizeof(buffer), &result) == 0 && result) return result->pw_name;
+        return std::to_string(uid);
     }
     
     void show_network_status() {
         append_text("\n=== NETWORK STATUS ===\n");
         update_status("Loading network information...");
         
-        FILE* pipe = popen("ss -tuln | head -10", "r");
-        if (pipe) {
-            char buffer[256];
-            bool has_output = false;
-            while (fgets(buffer, sizeof(buffer), pipe)) {
-                append_text(std::string(buffer));
-                has_output = true;
+        start_worker([this]() {
+            Tracer::set_thread_name("network worker");
+            WorkerGauge worker_gauge;
+            SocketCollector collector;
+            std::vector<char> buffer(16 * 1024);
+            SocketStateCounts tcp, udp;
+            std::vector<ListeningSocket> listeners;
+            bool counted = collector.count_all(SocketCollector::ALL_STATES, tcp, udp, buffer.data(), buffer.size());
+            bool listed = collector.listening(listeners, buffer.data(), buffer.size());
+            if (!counted && !listed) {
+                post_text(std::make_shared<std::string>("Error: Could not query sockets (NETLINK_SOCK_DIAG unavailable).\n\n"));
+                post_status("Error: network information unavailable");
+                return;
             }
-            pclose(pipe);
             
-            if (!has_output) {
-                append_text("No network connections found.\n");
+            std::string text = "Sockets by state:\n" + format_states("TCP", tcp) + format_states("UDP", udp);
+            text += "Listening (" + std::to_string(listeners.size()) + "):\n";
+            text += "  Proto Local Address:Port                              UID\n";
+            size_t shown = std::min<size_t>(listeners.size(), MAX_LISTENERS_SHOWN);
+            for (size_t i = 0; i < shown; i++) {
+                const ListeningSocket& socket = listeners[i];
+                std::string proto = std::string(socket.udp ? "udp" : "tcp") + (socket.family == AF_INET6 ? "6" : "");
+                std::string local = socket.family == AF_INET6 ? "[" + socket.address + "]" : socket.address;
+                local += ":" + std::to_string(socket.port);
+                char line[128];
+                snprintf(line, sizeof(line), "  %-5s %-46s %u\n", proto.c_str(), local.c_str(), socket.uid);
+                text += line;
             }
-        } else {
-            append_text("Error: Could not retrieve network status.\n");
-            append_text("Trying alternative method...\n");
-            
-            FILE* alt_pipe = popen("netstat -tuln 2>/dev/null | head -10", "r");
-            if (alt_pipe) {
-                char buffer[256];
-                while (fgets(buffer, sizeof(buffer), alt_pipe)) {
-                    append_text(std::string(buffer));
-                }
-                pclose(alt_pipe);
-            } else {
-                append_text("Network tools not available.\n");
+            if (listeners.size() > shown) {
+                text += "  ... and " + std::to_string(listeners.size() - shown) + " more\n";
             }
+            if (listeners.empty()) text += "  No listening sockets found.\n";
+            post_text(std::make_shared<std::string>(text + "\n"));
+            post_status("Network status displayed");
+        });
+    }
+    
+    static constexpr size_t MAX_LISTENERS_SHOWN = 50;
+
+    static std::string format_states(const char* protocol, const SocketStateCounts& counts) {
+        std::string line = "  " + std::string(protocol) + ": " + std::to_string(counts.total) + " total";
+        for (int state = 1; state < SocketStateCounts::STATES; state++) {
+            if (counts.states[state] == 0) continue;
+            line += ", " + std::string(SocketCollector::state_name(state)) + " " + std::to_string(counts.states[state]);
         }
-        append_text("\n");
-        update_status("Network status displayed");
+        return line + "\n";
     }
     
     void show_services_status() {
@@ -941,31 +1158,74 @@ public:
         append_text("\n=== DISK INFORMATION ===\n");
         update_status("Loading disk information...");
         
-        FILE* pipe = popen("df -h | grep -E '^/dev'", "r");
-        if (pipe) {
-            char buffer[256];
-            append_text("Filesystem Usage:\n");
-            while (fgets(buffer, sizeof(buffer), pipe)) {
-                append_text(std::string(buffer));
-            }
-            pclose(pipe);
+        // Filesystems and I/O from the hardware monitor's latest sample
+        append_text("Filesystem Usage:\n");
+        append_text("Mounted on                     Type       Size    Used   Avail  Use%  IUse%\n");
+        for (const auto& mount : last_stats.mounts) {
+            char line[256];
+            snprintf(line, sizeof(line), "%-30s %-8s %7s %7s %7s %4d%% %5d%%%s\n", mount.mount_point.c_str(),
+                     mount.fstype.c_str(), human_size(mount.total_bytes).c_str(), human_size(mount.used_bytes).c_str(),
+                     human_size(mount.available_bytes).c_str(), (int)(mount.usage + 0.5), (int)(mount.inode_usage + 0.5),
+                     mount.timed_out ? "  not responding" : "");
+            append_text(line);
         }
-        
-        // Disk I/O stats
-        pipe = popen("iostat -d 1 1 2>/dev/null | tail -n +4 | head -5", "r");
-        if (pipe) {
-            char buffer[256];
-            append_text("\nDisk I/O Statistics:\n");
-            while (fgets(buffer, sizeof(buffer), pipe)) {
-                append_text(std::string(buffer));
-            }
-            pclose(pipe);
+        if (last_stats.mounts.empty()) append_text("No filesystems sampled yet.\n");
+        
+        append_text("\nDisk I/O Statistics:\n");
+        append_text("Device            r/s      w/s    rKB/s    wKB/s  await  %util\n");
+        for (const auto& device : last_stats.disk_devices) {
+            char line[128];
+            snprintf(line, sizeof(line), "%-12s %8.1f %8.1f %8.1f %8.1f %6.2f %6.1f\n", device.name.c_str(),
+                     device.read_iops, device.write_iops, device.read_bytes_per_sec / 1024.0,
+                     device.write_bytes_per_sec / 1024.0, device.await_ms, device.utilization);
+            append_text(line);
         }
+        if (last_stats.disk_devices.empty()) append_text("No disk activity sampled yet.\n");
         
         append_text("\n");
         update_status("Disk information displayed");
     }
     
+    // Pressure stalls and the services using the most CPU, for the load tooltip
+    static std::string format_unit_load(const HardwareStats& stats) {
+        static constexpr size_t UNITS_SHOWN = 5;
+        char line[160];
+        std::string text;
+        if (stats.pressure.available) {
+            snprintf(line, sizeof(line), "Stalled (avg10): cpu %.1f%%, memory %.1f%%, io %.1f%%",
+                     stats.pressure.cpu.some_avg10, stats.pressure.memory.some_avg10, stats.pressure.io.some_avg10);
+            text += line;
+        }
+        std::vector<const UnitResourceStats*> busiest;
+        for (const auto& unit : stats.units) busiest.push_back(&unit);
+        size_t shown = std::min(UNITS_SHOWN, busiest.size());
+        std::partial_sort(busiest.begin(), busiest.begin() + shown, busiest.end(),
+                          [](const UnitResourceStats* a, const UnitResourceStats* b) { return a->cpu_percent > b->cpu_percent; });
+        for (size_t i = 0; i < shown; i++) {
+            const UnitResourceStats& unit = *busiest[i];
+            snprintf(line, sizeof(line), "%s: %.1f%% cpu, %s memory, %s/s I/O", unit.unit.c_str(), unit.cpu_percent,
+                     human_size(unit.memory_bytes).c_str(),
+                     human_size(static_cast<uint64_t>(unit.read_bytes_per_sec + unit.write_bytes_per_sec)).c_str());
+            if (!text.empty()) text += "\n";
+            text += line;
+        }
+        return text;
+    }
+
+    // 1K-based like df -h
+    static std::string human_size(uint64_t bytes) {
+        static const char* units[] = {"B", "K", "M", "G", "T", "P"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (value >= 1024.0 && unit < 5) {
+            value /= 1024.0;
+            unit++;
+        }
+        char text[16];
+        snprintf(text, sizeof(text), value < 10.0 && unit > 0 ? "%.1f%s" : "%.0f%s", value, units[unit]);
+        return text;
+    }
+    
     void export_analysis() {
         GtkWidget *dialog = gtk_file_chooser_dialog_new("Export Analysis",
                                                        GTK_WINDOW(window),
@@ -997,7 +1257,7 @@ public:
             FILE *file = fopen(filename, "w");
             if (file) {
                 fprintf(file, "# ArchLog Analysis Export\n");
-                fprintf(file, "# Generated: %s\n", get_current_time().c_str());
+                fprintf(file, "# Generated: %s\n", JournalFormatter::get_current_time().c_str());
                 fprintf(file, "# System: %s\n\n", get_system_info_brief().c_str());
                 fputs(text, file);
                 fclose(file);
@@ -1016,7 +1276,8 @@ public:
     void stop_analysis() {
         if (is_running.load()) {
             is_running.store(false);
-            monitor_running.store(false);
+            hardware_scheduler.stop();
+            replay_running.store(false);
             gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(progress_bar), 0.0);
             gtk_progress_bar_set_text(GTK_PROGRESS_BAR(progress_bar), "Stopped");
             update_status("⏹️ Analysis stopped by user");
@@ -1025,14 +1286,6 @@ public:
         }
     }
     
-    std::string get_current_time() {
-        time_t now = time(0);
-        struct tm* tm_info = localtime(&now);
-        char time_str[64];
-        strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", tm_info);
-        return std::string(time_str);
-    }
-    
     std::string get_system_info_brief() {
         std::string info = "Arch Linux";
         FILE* pipe = popen("uname -r 2>/dev/null", "r");
@@ -1049,7 +1302,7 @@ public:
     }
     
     void run_security_scan() {
-        StructuredLogger::security("security_scan", "/gui", "Security scan initiated");
+        ARCHLOG_LOG(LogLevel::WARN, LogCategory::SECURITY, "security_scan", "/gui", "Security scan initiated");
         append_text("\n=== SECURITY SCAN ===\n");
         update_status("Running security scan...");
         
@@ -1080,7 +1333,7 @@ public:
             pclose(pipe);
         }
         
-        StructuredLogger::security("security_scan", "/gui", "Security scan completed");
+        ARCHLOG_LOG(LogLevel::WARN, LogCategory::SECURITY, "security_scan", "/gui", "Security scan completed");
         update_status("Security scan completed");
     }
     
@@ -1089,35 +1342,43 @@ public:
         append_text("\n=== PERFORMANCE ANALYSIS ===\n");
         update_status("Analyzing system performance...");
         
-        auto stats = HardwareMonitor::get_current_stats();
-        
-        append_text("[INFO] [PERFORMANCE] cpu_monitor (/proc/stat) | CPU Usage: " + 
-                   std::to_string((int)stats.cpu_usage) + "%\n");
-        append_text("[INFO] [PERFORMANCE] mem_monitor (/proc/meminfo) | Memory Usage: " + 
-                   std::to_string((int)stats.memory_usage) + "%\n");
-        append_text("[INFO] [PERFORMANCE] disk_monitor (/proc/diskstats) | Disk Usage: " + 
-                   std::to_string((int)stats.disk_usage) + "%\n");
-        append_text("[INFO] [PERFORMANCE] load_monitor (/proc/loadavg) | System Load: " + 
-                   stats.system_load + "\n");
-        
-        // Top processes
-        append_text("\n[INFO] [PERFORMANCE] process_monitor (/proc) | Top CPU processes:\n");
-        FILE* pipe = popen("ps aux --sort=-%cpu | head -5 | tail -4", "r");
-        if (pipe) {
-            char buffer[256];
-            while (fgets(buffer, sizeof(buffer), pipe)) {
-                append_text("[INFO] [PERFORMANCE] ps (/proc) | " + std::string(buffer));
+        start_worker([this]() {
+            Tracer::set_thread_name("performance worker");
+            WorkerGauge worker_gauge;
+            auto stats = HardwareMonitor::get_current_stats();
+            
+            std::string report;
+            report += "[INFO] [PERFORMANCE] cpu_monitor (/proc/stat) | CPU Usage: " + 
+                      std::to_string((int)stats.cpu_usage) + "% (user " + std::to_string((int)stats.cpu_total.user) +
+                      "%, system " + std::to_string((int)stats.cpu_total.system) + "%, iowait " +
+                      std::to_string((int)stats.cpu_total.iowait) + "%, steal " + std::to_string((int)stats.cpu_total.steal) + "%)\n";
+            for (const auto& core : stats.cpu_cores) {
+                report += "[INFO] [PERFORMANCE] cpu_monitor (/proc/stat) | cpu" + std::to_string(core.core) + ": " +
+                          std::to_string((int)core.usage) + "%\n";
             }
-            pclose(pipe);
-        }
-        
-        std::map<std::string, std::string> metrics = {
-            {"cpu_usage", std::to_string(stats.cpu_usage)},
-            {"memory_usage", std::to_string(stats.memory_usage)},
-            {"disk_usage", std::to_string(stats.disk_usage)}
-        };
-        StructuredLogger::performance("perf_analysis", "/gui", "Performance analysis completed", metrics);
-        update_status("Performance analysis completed");
+            report += "[INFO] [PERFORMANCE] mem_monitor (/proc/meminfo) | Memory Usage: " + 
+                      std::to_string((int)stats.memory_usage) + "%\n";
+            report += "[INFO] [PERFORMANCE] disk_monitor (/proc/diskstats) | Disk Usage: " + 
+                      std::to_string((int)stats.disk_usage) + "%\n";
+            report += "[INFO] [PERFORMANCE] load_monitor (/proc/loadavg) | System Load: " + 
+                      stats.system_load + "\n";
+            
+            // Top processes
+            std::vector<ProcessStats> top_cpu, top_memory;
+            if (sample_processes(4, top_cpu, top_memory)) {
+                report += "\n[INFO] [PERFORMANCE] process_monitor (/proc) | Top CPU processes:\n";
+                report += format_processes(top_cpu, "[INFO] [PERFORMANCE] process_monitor (/proc) | ");
+            }
+            post_text(std::make_shared<std::string>(report));
+            
+            LogMetadata metrics = {
+                {"cpu_usage", std::to_string(stats.cpu_usage)},
+                {"memory_usage", std::to_string(stats.memory_usage)},
+                {"disk_usage", std::to_string(stats.disk_usage)}
+            };
+            StructuredLogger::performance("perf_analysis", "/gui", "Performance analysis completed", metrics);
+            post_status("Performance analysis completed");
+        });
     }
     
     void export_structured_logs() {
@@ -1149,10 +1410,10 @@ public:
                 
                 fclose(file);
                 update_status("📋 Structured logs exported to: " + std::string(filename));
-                StructuredLogger::info("export", "/gui", "Logs exported to " + std::string(filename));
+                ARCHLOG_INFO("export", "/gui", "Logs exported to {}", filename);
             } else {
                 update_status("❌ Error: Could not export file");
-                StructuredLogger::error("export", "/gui", "Failed to export to " + std::string(filename));
+                ARCHLOG_ERROR("export", "/gui", "Failed to export to {}", filename);
             }
             
             g_free(filename);
@@ -1161,6 +1422,53 @@ public:
         gtk_widget_destroy(dialog);
     }
 
+    // Tracks live worker threads for the metrics endpoint
+    struct WorkerGauge {
+        WorkerGauge() { Metrics::gauge_add(MetricGauge::GUI_WORKERS, 1); }
+        ~WorkerGauge() { Metrics::gauge_add(MetricGauge::GUI_WORKERS, -1); }
+    };
+
+    // Runs fn on a thread the destructor joins; finished ones are joined here
+    template <typename Fn>
+    void start_worker(Fn fn) {
+        workers.erase(std::remove_if(workers.begin(), workers.end(), [](Worker& worker) {
+            if (!worker.done->load()) return false;
+            worker.thread.join();
+            return true;
+        }), workers.end());
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        workers.push_back({std::thread([fn, done]() {
+            fn();
+            done->store(true);
+        }), done});
+    }
+
+    // Hands a chunk of worker output to the GTK main loop
+    void post_text(std::shared_ptr<std::string> text) {
+        struct PendingText { ModernArchLogGUI* gui; std::shared_ptr<std::string> text; uint64_t queued_ns; };
+        Metrics::gauge_add(MetricGauge::UI_QUEUE_DEPTH, 1); // Before the callback can run and decrement
+        g_idle_add([](gpointer data) -> gboolean {
+            auto pending = static_cast<PendingText*>(data);
+            Metrics::gauge_add(MetricGauge::UI_QUEUE_DEPTH, -1);
+            Tracer::async("ui queue wait", "ui", pending->queued_ns, Tracer::now_ns());
+            {
+                ARCHLOG_PROFILE_SCOPE(ProfileStage::UI_APPEND);
+                pending->gui->append_text(*pending->text);
+            }
+            delete pending;
+            return G_SOURCE_REMOVE;
+        }, new PendingText{this, std::move(text), Tracer::now_ns()});
+    }
+
+    void post_status(std::string message) {
+        g_idle_add([](gpointer data) -> gboolean {
+            auto pending = static_cast<std::pair<ModernArchLogGUI*, std::string>*>(data);
+            pending->first->update_status(pending->second);
+            delete pending;
+            return G_SOURCE_REMOVE;
+        }, new std::pair<ModernArchLogGUI*, std::string>(this, std::move(message)));
+    }
+
     void append_text(const std::string& text) {
         std::lock_guard<std::mutex> lock(buffer_mutex);
         GtkTextIter end;
@@ -1176,96 +1484,60 @@ public:
     void update_status(const std::string& message) {
         gtk_label_set_text(GTK_LABEL(status_label), message.c_str());
     }
-    
-    std::string format_log_entry(const std::string& json_line, int entry_num) {
-        // Extract key fields from JSON and format as structured log
-        std::string timestamp = extract_json_field(json_line, "__REALTIME_TIMESTAMP");
-        std::string message = extract_json_field(json_line, "MESSAGE");
-        std::string unit = extract_json_field(json_line, "_SYSTEMD_UNIT");
-        std::string priority = extract_json_field(json_line, "PRIORITY");
-        std::string comm = extract_json_field(json_line, "_COMM");
-        
-        if (unit.empty()) unit = comm.empty() ? "system" : comm;
-        if (message.empty()) message = "No message";
-        
-        std::string level = priority_to_level_name(priority);
-        std::string formatted_time = format_timestamp(timestamp);
-        
-        std::stringstream formatted;
-        formatted << "[" << std::setfill('0') << std::setw(4) << entry_num << "] "
-                 << "[" << formatted_time << "] "
-                 << "[" << level << "] "
-                 << "[SYSTEM] "
-                 << unit << " (/var/log/journal) | "
-                 << message << "\n";
-        
-        return formatted.str();
-    }
-    
-    std::string extract_json_field(const std::string& json, const std::string& field) {
-        std::string search = "\"" + field + "\"";
-        size_t pos = json.find(search);
-        if (pos == std::string::npos) return "";
-        
-        pos = json.find(':', pos);
-        if (pos == std::string::npos) return "";
-        
-        pos = json.find('"', pos);
-        if (pos == std::string::npos) return "";
-        pos++;
-        
-        size_t end = json.find('"', pos);
-        if (end == std::string::npos) return "";
-        
-        return json.substr(pos, end - pos);
+};
+
+// Writes the --trace-out file however main() returns
+struct TraceReport {
+    std::string path;
+    ~TraceReport() {
+        if (!path.empty()) Tracer::write_chrome_trace(path);
     }
+};
+
+int main(int argc, char** argv) {
+    StructuredLogger::initialize();
+    ARCHLOG_LOG(LogLevel::INFO, LogCategory::SYSTEM, "archlog_gui", "/usr/bin", "ArchLog GUI starting");
     
-    std::string priority_to_level_name(const std::string& priority) {
-        if (priority.empty()) return "INFO";
-        int p = std::stoi(priority);
-        switch (p) {
-            case 0: return "EMERG";
-            case 1: return "ALERT";
-            case 2: return "CRIT";
-            case 3: return "ERROR";
-            case 4: return "WARN";
-            case 5: return "NOTICE";
-            case 6: return "INFO";
-            case 7: return "DEBUG";
-            default: return "INFO";
+    TraceReport trace_report;
+    MetricsEndpoint metrics_endpoint;
+    std::string replay_path;
+    double replay_speed = 1.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.find("--trace-out=") == 0 && arg.length() > 12) {
+            trace_report.path = arg.substr(12);
+            Tracer::enable();
+            Tracer::set_thread_name("gtk main");
+        } else if (arg.find("--metrics=") == 0) {
+            metrics_endpoint.start(arg.substr(10));
+        } else if (arg.find("--record=") == 0) {
+            Recorder::shared().open(arg.substr(9));
+        } else if (arg.find("--replay=") == 0) {
+            replay_path = arg.substr(9);
+        } else if (arg.find("--speed=") == 0) {
+            replay_speed = ReplayClock::parse_speed(arg.substr(8));
+            if (replay_speed < 0.0) {
+                ARCHLOG_WARN("archlog_gui", "/usr/bin", "Invalid replay speed {}, using 1x", arg);
+                replay_speed = 1.0;
+            }
         }
     }
     
-    std::string format_timestamp(const std::string& us_timestamp) {
-        if (us_timestamp.empty()) return get_current_time();
-        try {
-            long long us = std::stoll(us_timestamp);
-            time_t seconds = us / 1000000;
-            struct tm* tm_info = localtime(&seconds);
-            char buffer[32];
-            strftime(buffer, sizeof(buffer), "%H:%M:%S", tm_info);
-            return std::string(buffer);
-        } catch (...) {
-            return get_current_time();
-        }
-    }
-};
-
-int main(int, char**) {
-    StructuredLogger::initialize();
-    StructuredLogger::system("archlog_gui", "/usr/bin", "ArchLog GUI starting");
+    std::string history_path = StatsHistory::default_path();
+    if (!history_path.empty()) StatsHistory::shared().load(history_path);
     
     try {
-        ModernArchLogGUI gui;
+        ModernArchLogGUI gui(replay_path, replay_speed);
         if (gui.is_initialized()) {
             gui.run();
+            ModernArchLogGUI::save_history();
         } else {
-            StructuredLogger::warn("archlog_gui", "/usr/bin", "GUI not initialized - headless mode");
+            ARCHLOG_WARN("archlog_gui", "/usr/bin", "GUI not initialized - headless mode");
             return 0;
         }
         return 0;
     } catch (const std::exception& e) {
-        StructuredLogger::error("archlog_gui", "/usr/bin", std::string("GUI Error: ") + e.what());
+        ARCHLOG_ERROR("archlog_gui", "/usr/bin", "GUI Error: {}", e.what());
         return 1;
     }
 }
\ No newline at end of file
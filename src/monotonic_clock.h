@@ -0,0 +1,18 @@
+#ifndef MONOTONIC_CLOCK_H
+#define MONOTONIC_CLOCK_H
+
+#include <cstdint>
+#include <ctime>
+
+// CLOCK_MONOTONIC in nanoseconds; the one timebase for collector rates,
+// metrics histograms and trace spans
+class MonotonicClock {
+public:
+    static uint64_t now_ns() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    }
+};
+
+#endif
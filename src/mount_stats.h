@@ -0,0 +1,249 @@
+#ifndef MOUNT_STATS_H
+#define MOUNT_STATS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <poll.h>
+#include <sys/statvfs.h>
+#include "proc_reader.h"
+
+struct MountUsage {
+    std::string mount_point;
+    std::string source;       // /dev/nvme0n1p2, server:/export, ...
+    std::string fstype;
+    bool remote = false;      // Network or FUSE filesystem, probed with a timeout
+    bool timed_out = false;   // statvfs did not answer in time; figures are from the last good probe
+    uint64_t total_bytes = 0;
+    uint64_t used_bytes = 0;
+    uint64_t available_bytes = 0; // To unprivileged users
+    double usage = 0.0;           // used / (used + available), as df reports it
+    uint64_t inodes_total = 0;
+    uint64_t inodes_used = 0;
+    double inode_usage = 0.0;
+};
+
+// Usage of every real filesystem. The mount table from /proc/self/mountinfo
+// is parsed once and again only when poll() reports a change on it. Local
+// filesystems are stat'ed inline; network and FUSE mounts are stat'ed on
+// helper threads that the sampler waits on for at most timeout in total, so
+// a hung NFS server leaves that mount marked timed_out instead of stalling
+// the sample. A mount whose previous probe is still stuck is not probed again
+// until it returns.
+class MountCollector {
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 500;
+
+    explicit MountCollector(std::chrono::milliseconds timeout = std::chrono::milliseconds(DEFAULT_TIMEOUT_MS))
+        : mountinfo_("/proc/self/mountinfo"), timeout_(timeout) {}
+
+    MountCollector(const MountCollector&) = delete;
+    MountCollector& operator=(const MountCollector&) = delete;
+
+    bool sample(std::vector<MountUsage>& mounts, char* buf, size_t capacity) {
+        if (!mountinfo_.is_open()) return false;
+        if (!loaded_ || table_changed()) {
+            if (!load(buf, capacity)) return false;
+        }
+
+        // Remote probes first so they run while the local ones are done inline
+        auto deadline = std::chrono::steady_clock::now() + timeout_;
+        for (Mount& mount : mounts_) {
+            if (!mount.usage.remote) continue;
+            mount.stuck = mount.probe && !mount.probe->finished(); // Still stuck from an earlier sample
+            if (mount.stuck) continue;
+            mount.probe = std::make_shared<Probe>();
+            std::thread([probe = mount.probe, path = mount.usage.mount_point]() {
+                struct statvfs st;
+                bool ok = statvfs(path.c_str(), &st) == 0;
+                probe->finish(ok, st);
+            }).detach();
+        }
+        for (Mount& mount : mounts_) {
+            if (mount.usage.remote) continue;
+            struct statvfs st;
+            if (statvfs(mount.usage.mount_point.c_str(), &st) == 0) apply(mount.usage, st);
+        }
+        for (Mount& mount : mounts_) {
+            if (!mount.usage.remote) continue;
+            if (mount.stuck) {
+                mount.usage.timed_out = true; // Its wait already ran out once; don't spend this sample's budget on it
+                continue;
+            }
+            struct statvfs st;
+            bool ok = false;
+            mount.usage.timed_out = !mount.probe->wait_until(deadline, ok, st);
+            if (ok) apply(mount.usage, st);
+        }
+
+        mounts.resize(mounts_.size());
+        for (size_t i = 0; i < mounts_.size(); i++) mounts[i] = mounts_[i].usage;
+        return true;
+    }
+
+    // Filesystems that hold no user data or never fill up in a meaningful way
+    static bool is_pseudo(const std::string& fstype) {
+        static const char* pseudo[] = {"proc", "sysfs", "cgroup", "cgroup2", "devpts", "devtmpfs", "tmpfs", "ramfs",
+                                       "securityfs", "debugfs", "tracefs", "pstore", "bpf", "mqueue", "hugetlbfs",
+                                       "configfs", "fusectl", "autofs", "binfmt_misc", "efivarfs", "nsfs",
+                                       "rpc_pipefs", "selinuxfs", "squashfs", "nfsd"};
+        for (const char* name : pseudo) {
+            if (fstype == name) return true;
+        }
+        return false;
+    }
+
+    static bool is_remote(const std::string& fstype) {
+        static const char* remote[] = {"nfs", "nfs4", "cifs", "smb3", "smbfs", "ceph", "glusterfs", "9p", "afs"};
+        for (const char* name : remote) {
+            if (fstype == name) return true;
+        }
+        return fstype.compare(0, 5, "fuse.") == 0 || fstype == "fuse";
+    }
+
+private:
+    // One statvfs on a helper thread; shared with it so a stuck probe can
+    // outlive the sample (or the collector) that started it
+    class Probe {
+    public:
+        void finish(bool ok, const struct statvfs& st) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+            ok_ = ok;
+            st_ = st;
+            finished_.notify_all();
+        }
+
+        bool finished() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return done_;
+        }
+
+        bool wait_until(std::chrono::steady_clock::time_point deadline, bool& ok, struct statvfs& st) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!finished_.wait_until(lock, deadline, [this] { return done_; })) return false;
+            ok = ok_;
+            st = st_;
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable finished_;
+        bool done_ = false;
+        bool ok_ = false;
+        struct statvfs st_ = {};
+    };
+
+    struct Mount {
+        MountUsage usage;
+        std::shared_ptr<Probe> probe;
+        bool stuck = false; // Probe from an earlier sample had not returned when this one started
+    };
+
+    // mountinfo raises POLLPRI (and POLLERR) once per mount table change
+    bool table_changed() {
+        struct pollfd fd = {mountinfo_.fd(), POLLPRI, 0};
+        return poll(&fd, 1, 0) > 0 && (fd.revents & (POLLPRI | POLLERR));
+    }
+
+    // "36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw,errors=continue"
+    bool load(char* buf, size_t capacity) {
+        std::vector<Mount> mounts;
+        std::vector<std::string> devices; // major:minor already listed (bind mounts share usage)
+        bool ok = mountinfo_.for_each_line(buf, capacity, [&](const char* p, const char* end) {
+            const char* fields[5];
+            const char* field_ends[5];
+            for (int i = 0; i < 5; i++) {
+                fields[i] = ProcScan::skip_spaces(p, end);
+                field_ends[i] = p = ProcScan::skip_token(fields[i], end);
+            }
+            // Optional fields run up to a lone "-"
+            const char* dash = p;
+            while (true) {
+                dash = ProcScan::skip_spaces(dash, end);
+                if (dash == end) return true;
+                const char* dash_end = ProcScan::skip_token(dash, end);
+                if (dash_end - dash == 1 && *dash == '-') {
+                    p = dash_end;
+                    break;
+                }
+                dash = dash_end;
+            }
+            const char* fstype = ProcScan::skip_spaces(p, end);
+            const char* fstype_end = ProcScan::skip_token(fstype, end);
+            const char* source = ProcScan::skip_spaces(fstype_end, end);
+            const char* source_end = ProcScan::skip_token(source, end);
+
+            Mount mount;
+            mount.usage.fstype.assign(fstype, fstype_end - fstype);
+            if (is_pseudo(mount.usage.fstype)) return true;
+            std::string device(fields[2], field_ends[2] - fields[2]);
+            if (std::find(devices.begin(), devices.end(), device) != devices.end()) return true;
+            devices.push_back(device);
+
+            mount.usage.mount_point = unescape(fields[4], field_ends[4]);
+            mount.usage.source = unescape(source, source_end);
+            mount.usage.remote = is_remote(mount.usage.fstype);
+            mounts.push_back(std::move(mount));
+            return true;
+        });
+        if (!ok) return false;
+
+        // Keep probes and last figures for mounts that are still there
+        for (Mount& mount : mounts) {
+            for (Mount& old : mounts_) {
+                if (old.usage.mount_point == mount.usage.mount_point && old.usage.fstype == mount.usage.fstype) {
+                    mount.usage = old.usage;
+                    mount.probe = std::move(old.probe);
+                    break;
+                }
+            }
+        }
+        mounts_.swap(mounts);
+        loaded_ = true;
+        return true;
+    }
+
+    // Spaces, tabs, newlines and backslashes in paths appear as \ooo octal
+    static std::string unescape(const char* p, const char* end) {
+        std::string text;
+        text.reserve(end - p);
+        while (p < end) {
+            if (*p == '\\' && end - p >= 4 && p[1] >= '0' && p[1] <= '3' && p[2] >= '0' && p[2] <= '7' &&
+                p[3] >= '0' && p[3] <= '7') {
+                text += static_cast<char>((p[1] - '0') * 64 + (p[2] - '0') * 8 + (p[3] - '0'));
+                p += 4;
+            } else {
+                text += *p++;
+            }
+        }
+        return text;
+    }
+
+    static void apply(MountUsage& usage, const struct statvfs& st) {
+        uint64_t block = st.f_frsize ? st.f_frsize : st.f_bsize;
+        usage.total_bytes = static_cast<uint64_t>(st.f_blocks) * block;
+        usage.available_bytes = static_cast<uint64_t>(st.f_bavail) * block;
+        usage.used_bytes = static_cast<uint64_t>(st.f_blocks - st.f_bfree) * block;
+        uint64_t usable = usage.used_bytes + usage.available_bytes;
+        usage.usage = usable > 0 ? usage.used_bytes * 100.0 / usable : 0.0;
+        usage.inodes_total = st.f_files;
+        usage.inodes_used = st.f_files >= st.f_ffree ? st.f_files - st.f_ffree : 0;
+        usage.inode_usage = usage.inodes_total > 0 ? usage.inodes_used * 100.0 / usage.inodes_total : 0.0;
+    }
+
+    ProcFile mountinfo_;
+    std::chrono::milliseconds timeout_;
+    bool loaded_ = false;
+    std::vector<Mount> mounts_;
+};
+
+#endif
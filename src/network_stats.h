@@ -0,0 +1,106 @@
+#ifndef NETWORK_STATS_H
+#define NETWORK_STATS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "proc_reader.h"
+
+struct NetworkInterfaceStats {
+    std::string name;
+    uint64_t rx_bytes = 0; // Cumulative counters from /proc/net/dev
+    uint64_t tx_bytes = 0;
+    double rx_bytes_per_sec = 0.0;
+    double tx_bytes_per_sec = 0.0;
+    double rx_packets_per_sec = 0.0;
+    double tx_packets_per_sec = 0.0;
+    double rx_errors_per_sec = 0.0;
+    double tx_errors_per_sec = 0.0;
+};
+
+// Per-interface rates from /proc/net/dev. Keeps the previous counters and a
+// CLOCK_MONOTONIC timestamp, so rates are real per-second values between two
+// samples; the first sample after an interface appears reports zero rates.
+class NetworkCollector {
+public:
+    NetworkCollector() : net_dev_("/proc/net/dev") {}
+
+    // Fills interfaces in /proc/net/dev order, reusing existing elements so a
+    // steady-state sample does not allocate. buf is scratch space for the read.
+    bool sample(std::vector<NetworkInterfaceStats>& interfaces, char* buf, size_t capacity) {
+        long length = 0;
+        const char* text = net_dev_.read_all(buf, capacity, length);
+        if (!text || length <= 0) {
+            interfaces.clear();
+            return false;
+        }
+
+        uint64_t now = MonotonicClock::now_ns();
+        double elapsed = previous_ns_ ? (now - previous_ns_) / 1e9 : 0.0;
+        previous_ns_ = now;
+
+        const char* end = text + length;
+        size_t count = 0;
+        // Two header lines, then "  name: rx bytes packets errs drop fifo frame compressed multicast tx bytes packets errs ..."
+        const char* line = ProcScan::next_line(ProcScan::next_line(text, end), end);
+        for (; line < end; line = ProcScan::next_line(line, end)) {
+            const char* line_end = ProcScan::next_line(line, end);
+            const char* colon = static_cast<const char*>(std::memchr(line, ':', line_end - line));
+            if (!colon) continue;
+            const char* name = ProcScan::skip_spaces(line, colon);
+
+            uint64_t fields[11] = {};
+            const char* p = colon + 1;
+            for (uint64_t& field : fields) {
+                p = ProcScan::parse_u64(p, line_end, field);
+                if (!p) break;
+            }
+            if (!p) continue;
+
+            Counters current = {fields[0], fields[1], fields[2], fields[8], fields[9], fields[10]};
+            if (count == interfaces.size()) interfaces.emplace_back();
+            NetworkInterfaceStats& stats = interfaces[count];
+            stats.name.assign(name, colon - name);
+            stats.rx_bytes = current.rx_bytes;
+            stats.tx_bytes = current.tx_bytes;
+
+            auto* entry = previous_.find(stats.name, count);
+            const Counters* previous = entry ? &entry->value : nullptr;
+            bool have_rate = previous && elapsed > 0.0;
+            stats.rx_bytes_per_sec = have_rate ? rate(current.rx_bytes, previous->rx_bytes, elapsed) : 0.0;
+            stats.tx_bytes_per_sec = have_rate ? rate(current.tx_bytes, previous->tx_bytes, elapsed) : 0.0;
+            stats.rx_packets_per_sec = have_rate ? rate(current.rx_packets, previous->rx_packets, elapsed) : 0.0;
+            stats.tx_packets_per_sec = have_rate ? rate(current.tx_packets, previous->tx_packets, elapsed) : 0.0;
+            stats.rx_errors_per_sec = have_rate ? rate(current.rx_errors, previous->rx_errors, elapsed) : 0.0;
+            stats.tx_errors_per_sec = have_rate ? rate(current.tx_errors, previous->tx_errors, elapsed) : 0.0;
+            previous_.touch(entry, stats.name, now).value = current;
+            count++;
+        }
+        interfaces.resize(count);
+
+        // Forget interfaces that went away
+        previous_.forget_unseen(now);
+        return true;
+    }
+
+    // Loopback traffic never leaves the host
+    static bool is_loopback(const NetworkInterfaceStats& stats) { return stats.name == "lo"; }
+
+private:
+    struct Counters {
+        uint64_t rx_bytes, rx_packets, rx_errors;
+        uint64_t tx_bytes, tx_packets, tx_errors;
+    };
+
+    // Counters that went backwards (driver reset, interface re-created) give no rate
+    static double rate(uint64_t current, uint64_t previous, double elapsed) {
+        return current >= previous ? (current - previous) / elapsed : 0.0;
+    }
+
+    ProcFile net_dev_;
+    uint64_t previous_ns_ = 0;
+    NameTable<Counters> previous_;
+};
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef NVIDIA_SMI_H
+#define NVIDIA_SMI_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "error_handler.h"
+
+extern char** environ;
+
+struct NvidiaGpuStats {
+    int index = 0;
+    double utilization = 0.0; // %
+    int temperature = 0;      // °C
+    double memory_used_mb = 0.0;
+    double memory_total_mb = 0.0;
+    double power_watts = 0.0;
+};
+
+// One long-lived `nvidia-smi --query-gpu=... -lms PERIOD` child whose CSV
+// stream is parsed on a reader thread as it arrives, replacing a popen() per
+// figure per sample. The child is restarted with exponential backoff when it
+// exits. $ARCHLOG_NVIDIA_SMI overrides the command (e.g. a script emitting
+// the same CSV for testing).
+class NvidiaSmiStream {
+public:
+    static constexpr int DEFAULT_PERIOD_MS = 1000;
+    static constexpr int MAX_RESTART_DELAY_MS = 30000;
+
+    explicit NvidiaSmiStream(int period_ms = DEFAULT_PERIOD_MS) : period_ms_(period_ms) {}
+
+    ~NvidiaSmiStream() { stop(); }
+
+    NvidiaSmiStream(const NvidiaSmiStream&) = delete;
+    NvidiaSmiStream& operator=(const NvidiaSmiStream&) = delete;
+
+    // Started on first use; stopped at exit
+    static NvidiaSmiStream& shared() {
+        static NvidiaSmiStream stream;
+        stream.start();
+        return stream;
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (reader_.joinable() || stopping_) return;
+        reader_ = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            if (child_ > 0) kill(-child_, SIGTERM); // Its whole group, so the read ends with EOF
+            changed_.notify_all();
+        }
+        if (reader_.joinable()) reader_.join();
+    }
+
+    // Latest reading of every GPU; false until the first line arrives, or
+    // when the stream has been silent for several periods
+    bool snapshot(std::vector<NvidiaGpuStats>& gpus) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (gpus_.empty() || std::chrono::steady_clock::now() - updated_ > std::chrono::milliseconds(period_ms_ * 5)) {
+            return false;
+        }
+        gpus = gpus_;
+        return true;
+    }
+
+    // For one-shot callers: waits for the first reading
+    bool wait_for_data(std::chrono::milliseconds timeout) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return changed_.wait_for(lock, timeout, [this] { return !gpus_.empty() || stopping_; }) && !gpus_.empty();
+    }
+
+    // "0, 37, 61, 1234, 8192, 85.20" (index, utilization, temperature,
+    // memory used/total MiB, power W); [N/A] and [Not Supported] read as 0
+    static bool parse_line(const char* p, const char* end, NvidiaGpuStats& gpu) {
+        double values[6];
+        for (int i = 0; i < 6; i++) {
+            while (p < end && *p == ' ') p++;
+            const char* field_end = static_cast<const char*>(std::memchr(p, ',', end - p));
+            if (!field_end) field_end = end;
+            if (field_end == p || (i < 5 && field_end == end)) return false;
+            char field[32];
+            size_t length = std::min<size_t>(field_end - p, sizeof(field) - 1);
+            std::memcpy(field, p, length);
+            field[length] = '\0';
+            char* parsed = nullptr;
+            values[i] = std::strtod(field, &parsed);
+            if (parsed == field) {
+                if (i == 0 || field[0] != '[') return false; // The index is never N/A
+                values[i] = 0.0;
+            }
+            p = field_end + 1;
+        }
+        gpu.index = static_cast<int>(values[0]);
+        gpu.utilization = std::clamp(values[1], 0.0, 100.0);
+        gpu.temperature = std::clamp(static_cast<int>(values[2]), 0, 150);
+        gpu.memory_used_mb = values[3];
+        gpu.memory_total_mb = values[4];
+        gpu.power_watts = values[5];
+        return true;
+    }
+
+private:
+    void run() {
+        int delay_ms = 1000;
+        bool reported = false;
+        while (true) {
+            auto started = std::chrono::steady_clock::now();
+            bool spawned = stream_once();
+            if (!spawned && !reported) {
+                reported = true;
+                ErrorHandler::log_error("Cannot start " + command() + ", NVIDIA GPU stats unavailable", ErrorLevel::WARNING);
+            }
+            // A child that ran for a while earns a quick restart
+            if (std::chrono::steady_clock::now() - started > std::chrono::seconds(60)) delay_ms = 1000;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (changed_.wait_for(lock, std::chrono::milliseconds(delay_ms), [this] { return stopping_; })) return;
+            delay_ms = std::min(delay_ms * 2, MAX_RESTART_DELAY_MS);
+        }
+    }
+
+    static std::string command() {
+        const char* override_command = getenv("ARCHLOG_NVIDIA_SMI");
+        return override_command && override_command[0] ? override_command : "nvidia-smi";
+    }
+
+    // Runs one child until its output ends; false if it could not be started
+    bool stream_once() {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0) return false;
+
+        std::string program = command();
+        std::string query = "--query-gpu=index,utilization.gpu,temperature.gpu,memory.used,memory.total,power.draw";
+        std::string format = "--format=csv,noheader,nounits";
+        std::string period = std::to_string(period_ms_);
+        char* argv[] = {&program[0], &query[0], &format[0], const_cast<char*>("-lms"), &period[0], nullptr};
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        // Own process group, so stopping also reaches whatever a wrapper script started
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attributes, 0);
+        pid_t pid = -1;
+        int error;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error = stopping_ ? ECANCELED : posix_spawnp(&pid, program.c_str(), &actions, &attributes, argv, environ);
+            if (error == 0) child_ = pid;
+            gpus_.clear(); // GPUs may have come or gone since the last child
+        }
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attributes);
+        close(fds[1]);
+        if (error != 0) {
+            close(fds[0]);
+            return false;
+        }
+
+        read_stream(fds[0]);
+        close(fds[0]);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            kill(-pid, SIGTERM); // In case it closed its stdout but kept running
+            child_ = -1;
+        }
+        int status;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+        return true;
+    }
+
+    // One line per GPU per period; each line updates its GPU as it arrives
+    void read_stream(int fd) {
+        char buffer[4096];
+        size_t used = 0;
+        while (true) {
+            ssize_t n = read(fd, buffer + used, sizeof(buffer) - used);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            used += static_cast<size_t>(n);
+
+            char* line = buffer;
+            char* end = buffer + used;
+            while (char* newline = static_cast<char*>(std::memchr(line, '\n', end - line))) {
+                char* line_end = newline > line && newline[-1] == '\r' ? newline - 1 : newline;
+                NvidiaGpuStats gpu;
+                if (parse_line(line, line_end, gpu)) publish(gpu);
+                line = newline + 1;
+            }
+            used = static_cast<size_t>(end - line);
+            if (used == sizeof(buffer)) used = 0; // A line longer than the buffer is garbage
+            std::memmove(buffer, line, used);
+        }
+    }
+
+    void publish(const NvidiaGpuStats& gpu) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::lower_bound(gpus_.begin(), gpus_.end(), gpu.index,
+                                   [](const NvidiaGpuStats& known, int index) { return known.index < index; });
+        if (it != gpus_.end() && it->index == gpu.index) {
+            *it = gpu;
+        } else {
+            gpus_.insert(it, gpu);
+        }
+        updated_ = std::chrono::steady_clock::now();
+        changed_.notify_all();
+    }
+
+    int period_ms_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable changed_;
+    std::thread reader_;
+    pid_t child_ = -1;
+    bool stopping_ = false;
+    std::vector<NvidiaGpuStats> gpus_;
+    std::chrono::steady_clock::time_point updated_;
+};
+
+#endif
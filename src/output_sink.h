@@ -0,0 +1,180 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include "error_handler.h"
+#include "log_analyzer.h"
+#include "json_escape.h"
+
+// Single reusable output buffer drained with write(2) in large chunks.
+class OutputBuffer {
+public:
+    static constexpr size_t CAPACITY = 64 * 1024;
+
+    explicit OutputBuffer(int fd = STDOUT_FILENO) : fd_(fd), data_(CAPACITY), length_(0), bytes_written_(0) {}
+    ~OutputBuffer() { flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void append(const char* str, size_t len) {
+        if (len > CAPACITY - length_) {
+            flush();
+            if (len >= CAPACITY) {
+                if (!failed_) write_all(str, len);
+                return;
+            }
+        }
+        std::memcpy(data_.data() + length_, str, len);
+        length_ += len;
+    }
+
+    void append(const std::string& str) { append(str.data(), str.size()); }
+
+    void put(char c) {
+        if (length_ == CAPACITY) flush();
+        data_[length_++] = c;
+    }
+
+    // A failed write is reported once; later output is discarded
+    bool flush() {
+        if (failed_) {
+            length_ = 0;
+            return false;
+        }
+        if (length_ == 0) return true;
+        bool ok = write_all(data_.data(), length_);
+        length_ = 0;
+        return ok;
+    }
+
+    size_t bytes_written() const { return bytes_written_ + length_; }
+
+    bool failed() const { return failed_; }
+
+private:
+    bool write_all(const char* str, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd_, str, len);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ErrorHandler::handle_system_error("output write", errno);
+                failed_ = true;
+                return false;
+            }
+            str += n;
+            len -= static_cast<size_t>(n);
+            bytes_written_ += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    int fd_;
+    std::vector<char> data_;
+    size_t length_;
+    size_t bytes_written_;
+    bool failed_ = false;
+};
+
+// Output formats. Each policy appends one entry without any runtime format dispatch.
+struct TextFormat {
+    static void header(OutputBuffer&) {}
+
+    static void write(OutputBuffer& out, const LogEntry& entry) {
+        out.put('[');
+        out.append(entry.timestamp);
+        out.append("] ", 2);
+        out.append(entry.level);
+        out.put(' ');
+        out.append(entry.service);
+        out.append(": ", 2);
+        out.append(entry.message);
+        out.put('\n');
+    }
+};
+
+// RFC 4180: fields containing separators, quotes or line breaks are quoted, quotes doubled.
+struct CsvFormat {
+    static void header(OutputBuffer& out) {
+        out.append("Timestamp,Level,Service,Message\r\n", 33);
+    }
+
+    static void write(OutputBuffer& out, const LogEntry& entry) {
+        write_field(out, entry.timestamp);
+        out.put(',');
+        write_field(out, entry.level);
+        out.put(',');
+        write_field(out, entry.service);
+        out.put(',');
+        write_field(out, entry.message);
+        out.append("\r\n", 2);
+    }
+
+    // RFC 4180 field, quoted only when it has to be; Out is OutputBuffer or std::string
+    template <typename Out>
+    static void write_field(Out& out, const std::string& field) {
+        bool needs_quotes = false;
+        for (char c : field) {
+            if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+                needs_quotes = true;
+                break;
+            }
+        }
+        if (!needs_quotes) {
+            out.append(field.data(), field.size());
+            return;
+        }
+        out.append("\"", 1);
+        const char* data = field.data();
+        size_t start = 0;
+        for (size_t i = 0; i < field.size(); i++) {
+            if (data[i] == '"') {
+                out.append(data + start, i - start + 1);
+                out.append("\"", 1);
+                start = i + 1;
+            }
+        }
+        out.append(data + start, field.size() - start);
+        out.append("\"", 1);
+    }
+};
+
+// Newline-delimited JSON, one object per entry.
+struct NdjsonFormat {
+    static void header(OutputBuffer&) {}
+
+    static void write(OutputBuffer& out, const LogEntry& entry) {
+        out.append("{\"timestamp\":\"", 14);
+        write_escaped(out, entry.timestamp);
+        out.append("\",\"level\":\"", 11);
+        write_escaped(out, entry.level);
+        out.append("\",\"service\":\"", 13);
+        write_escaped(out, entry.service);
+        out.append("\",\"message\":\"", 13);
+        write_escaped(out, entry.message);
+        out.append("\"}\n", 3);
+    }
+
+private:
+    static void write_escaped(OutputBuffer& out, const std::string& str) {
+        JsonEscape::append(out, str);
+    }
+};
+
+template <typename Format>
+class OutputSink {
+public:
+    static void write(OutputBuffer& out, const std::vector<LogEntry>& entries) {
+        Format::header(out);
+        for (const auto& entry : entries) {
+            Format::write(out, entry);
+        }
+        out.flush();
+    }
+};
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "monotonic_clock.h"
+
+// A /proc or /sys file opened once and re-read from offset 0 with pread(2),
+// so periodic sampling costs one syscall per file instead of an open/close
+// and an ifstream.
+class ProcFile {
+public:
+    ProcFile() = default;
+    explicit ProcFile(const char* path) { open(path); }
+    ~ProcFile() { close(); }
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    bool open(const char* path) {
+        close();
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        return fd_ >= 0;
+    }
+
+    void close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+
+    int fd() const { return fd_; }
+
+    // Reads the file from the start into buf (NUL terminated, truncated to
+    // capacity - 1). Returns the length, or -1 if the file is not open or
+    // the read fails.
+    long read(char* buf, size_t capacity) const { return read_at(buf, capacity, 0); }
+
+    long read_at(char* buf, size_t capacity, uint64_t offset) const {
+        if (fd_ < 0 || capacity == 0) return -1;
+        size_t length = 0;
+        while (length < capacity - 1) {
+            ssize_t n = pread(fd_, buf + length, capacity - 1 - length, static_cast<off_t>(offset + length));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            if (n == 0) break;
+            length += static_cast<size_t>(n);
+        }
+        buf[length] = '\0';
+        return static_cast<long>(length);
+    }
+
+    // Whole-file read for tables that must not lose their tail (/proc/stat
+    // on many CPUs, /proc/diskstats on many devices). Reads into buf when the
+    // file fits; otherwise into an internal buffer that is doubled until it
+    // does and kept for later reads, so the steady state does not allocate.
+    // Returns the NUL-terminated text and its length, or nullptr.
+    const char* read_all(char* buf, size_t capacity, long& length) {
+        if (large_.empty()) {
+            length = read(buf, capacity);
+            if (length < 0) return nullptr;
+            if (static_cast<size_t>(length) + 1 < capacity) return buf;
+            large_.resize(capacity * 2);
+        }
+        while (true) {
+            length = read(large_.data(), large_.size());
+            if (length < 0) return nullptr;
+            if (static_cast<size_t>(length) + 1 < large_.size()) return large_.data();
+            large_.resize(large_.size() * 2);
+        }
+    }
+
+    // Streams the file through buf line by line, for files that may not fit
+    // (e.g. /proc/net/tcp on a busy host). fn(begin, end) gets each line
+    // without its newline and returns false to stop early. Lines longer than
+    // the buffer are split.
+    template <typename Fn>
+    bool for_each_line(char* buf, size_t capacity, Fn fn) const {
+        if (fd_ < 0 || capacity < 2) return false;
+        uint64_t offset = 0;
+        size_t carry = 0;
+        while (true) {
+            ssize_t n;
+            do {
+                n = pread(fd_, buf + carry, capacity - carry, static_cast<off_t>(offset));
+            } while (n < 0 && errno == EINTR);
+            if (n < 0) return false;
+            if (n == 0) {
+                if (carry > 0) fn(static_cast<const char*>(buf), static_cast<const char*>(buf + carry));
+                return true;
+            }
+            offset += static_cast<uint64_t>(n);
+
+            const char* p = buf;
+            const char* end = buf + carry + n;
+            while (true) {
+                const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!newline) break;
+                if (!fn(p, newline)) return true;
+                p = newline + 1;
+            }
+            carry = static_cast<size_t>(end - p);
+            if (carry == capacity) {
+                if (!fn(p, end)) return true;
+                carry = 0;
+            }
+            std::memmove(buf, p, carry);
+        }
+    }
+
+private:
+    int fd_ = -1;
+    std::vector<char> large_;
+};
+
+// Allocation-free scanners over the text /proc hands back
+class ProcScan {
+public:
+    static const char* skip_spaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        return p;
+    }
+
+    static const char* skip_token(const char* p, const char* end) {
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\n') p++;
+        return p;
+    }
+
+    // Parses an unsigned decimal after optional blanks. Returns the position
+    // after the digits, or nullptr when there are none.
+    static const char* parse_u64(const char* p, const char* end, uint64_t& value) {
+        p = skip_spaces(p, end);
+        if (p == end || *p < '0' || *p > '9') return nullptr;
+        uint64_t v = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            v = v * 10 + static_cast<uint64_t>(*p - '0');
+            p++;
+        }
+        value = v;
+        return p;
+    }
+
+    static const char* parse_i64(const char* p, const char* end, int64_t& value) {
+        p = skip_spaces(p, end);
+        bool negative = p < end && *p == '-';
+        uint64_t magnitude = 0;
+        p = parse_u64(negative ? p + 1 : p, end, magnitude);
+        if (p) value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+        return p;
+    }
+
+    static const char* next_line(const char* p, const char* end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        return newline ? newline + 1 : end;
+    }
+
+    // Finds the line starting with key and returns the position just after it
+    static const char* find_line(const char* p, const char* end, const char* key) {
+        size_t key_length = std::strlen(key);
+        while (p < end) {
+            if (static_cast<size_t>(end - p) >= key_length && std::memcmp(p, key, key_length) == 0) {
+                return p + key_length;
+            }
+            p = next_line(p, end);
+        }
+        return nullptr;
+    }
+};
+
+// State a collector carries per device or interface name from one sample to
+// the next, such as its previous counters. Entries the latest sample did not
+// touch are dropped by forget_unseen(), so names that go away do not pile up.
+template <typename Value>
+class NameTable {
+public:
+    struct Entry {
+        std::string name;
+        Value value = {};
+        uint64_t seen = 0; // Timestamp of the last sample that touched it
+    };
+
+    // Names rarely change order between samples, so hint (the name's index
+    // in the previous sample) is tried first
+    Entry* find(const char* name, size_t length, size_t hint = 0) {
+        if (hint < entries_.size() && matches(entries_[hint], name, length)) return &entries_[hint];
+        for (auto& entry : entries_) {
+            if (matches(entry, name, length)) return &entry;
+        }
+        return nullptr;
+    }
+
+    Entry* find(const std::string& name, size_t hint = 0) { return find(name.data(), name.size(), hint); }
+
+    // entry (from find) or a new one for name when it was not found, marked seen at now
+    Entry& touch(Entry* entry, const char* name, size_t length, uint64_t now) {
+        if (!entry) {
+            entries_.emplace_back();
+            entry = &entries_.back();
+            entry->name.assign(name, length);
+        }
+        entry->seen = now;
+        return *entry;
+    }
+
+    Entry& touch(Entry* entry, const std::string& name, uint64_t now) { return touch(entry, name.data(), name.size(), now); }
+
+    void forget_unseen(uint64_t now) {
+        for (size_t i = 0; i < entries_.size();) {
+            if (entries_[i].seen != now) {
+                entries_[i] = std::move(entries_.back());
+                entries_.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+
+private:
+    static bool matches(const Entry& entry, const char* name, size_t length) {
+        return entry.name.size() == length && std::memcmp(entry.name.data(), name, length) == 0;
+    }
+
+    std::vector<Entry> entries_;
+};
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef PROCESS_STATS_H
+#define PROCESS_STATS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "proc_reader.h"
+
+struct ProcessStats {
+    int pid = 0;
+    unsigned uid = 0;
+    char state = '?';
+    std::string command;       // comm, at most 15 characters
+    double cpu_percent = 0.0;  // Of one CPU since the previous sample, like top
+    double memory_percent = 0.0;
+    uint64_t rss_bytes = 0;
+};
+
+// Scans /proc/[pid]/stat for every process and keeps the top K by CPU and by
+// resident memory. CPU usage is the tick delta since the previous sample; a
+// PID whose start time changed is a new process and starts from zero. The
+// per-process table is two sorted vectors swapped between samples, so after
+// the first scan a sample allocates only for the K results.
+class ProcessCollector {
+public:
+    ProcessCollector()
+        : ticks_per_sec_(sysconf(_SC_CLK_TCK)), page_size_(sysconf(_SC_PAGESIZE)),
+          total_pages_(sysconf(_SC_PHYS_PAGES)) {
+        proc_fd_ = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+
+    ~ProcessCollector() {
+        if (proc_fd_ >= 0) close(proc_fd_);
+    }
+
+    ProcessCollector(const ProcessCollector&) = delete;
+    ProcessCollector& operator=(const ProcessCollector&) = delete;
+
+    bool has_baseline() const { return previous_ns_ != 0; }
+
+    // Time since the previous sample; deltas over a long gap are averages
+    uint64_t baseline_age_ns() const { return previous_ns_ ? MonotonicClock::now_ns() - previous_ns_ : 0; }
+
+    size_t process_count() const { return previous_.size(); }
+
+    // Fills the K busiest and K largest processes, highest first. The first
+    // call only records a baseline, so every cpu_percent is zero.
+    bool sample(size_t k, std::vector<ProcessStats>& top_cpu, std::vector<ProcessStats>& top_memory) {
+        DIR* dir = proc_fd_ >= 0 ? opendir("/proc") : nullptr;
+        if (!dir) return false;
+
+        uint64_t now = MonotonicClock::now_ns();
+        double elapsed_ticks = previous_ns_ ? (now - previous_ns_) / 1e9 * ticks_per_sec_ : 0.0;
+        previous_ns_ = now;
+
+        current_.clear();
+        cpu_heap_.clear();
+        memory_heap_.clear();
+        bool sorted = true;
+        size_t cursor = 0;
+        while (struct dirent* entry = readdir(dir)) {
+            int pid = parse_pid(entry->d_name);
+            if (pid <= 0) continue;
+
+            Process process;
+            if (!read_process(pid, process)) continue; // Exited since readdir
+            if (!current_.empty() && pid < current_.back().pid) sorted = false;
+
+            // readdir on /proc returns PIDs in ascending order, so the
+            // previous table is walked alongside rather than searched
+            while (cursor < previous_.size() && previous_[cursor].pid < pid) cursor++;
+            const Process* before = cursor < previous_.size() && previous_[cursor].pid == pid ? &previous_[cursor] : nullptr;
+            if (!before && !sorted) before = find_previous(pid);
+            bool same = before && before->start_time == process.start_time && process.ticks >= before->ticks;
+            process.cpu_percent = same && elapsed_ticks > 0.0 ? (process.ticks - before->ticks) * 100.0 / elapsed_ticks : 0.0;
+
+            current_.push_back(process);
+            push_top(cpu_heap_, k, {process.cpu_percent, current_.size() - 1});
+            push_top(memory_heap_, k, {static_cast<double>(process.rss_pages), current_.size() - 1});
+        }
+        closedir(dir);
+
+        fill(cpu_heap_, top_cpu);
+        fill(memory_heap_, top_memory);
+        if (!sorted) {
+            std::sort(current_.begin(), current_.end(), [](const Process& a, const Process& b) { return a.pid < b.pid; });
+        }
+        previous_.swap(current_);
+        return true;
+    }
+
+private:
+    struct Process {
+        int pid = 0;
+        char state = '?';
+        char comm[16] = {};
+        uint64_t ticks = 0;       // utime + stime
+        uint64_t start_time = 0;  // Ticks after boot; tells a reused PID apart
+        uint64_t rss_pages = 0;
+        double cpu_percent = 0.0;
+    };
+
+    struct Ranked {
+        double key;
+        size_t index; // Into current_
+    };
+
+    static int parse_pid(const char* name) {
+        int pid = 0;
+        for (const char* p = name; *p; p++) {
+            if (*p < '0' || *p > '9') return 0;
+            pid = pid * 10 + (*p - '0');
+        }
+        return pid;
+    }
+
+    // "pid (comm) state ppid ..." where comm may itself contain spaces and
+    // parentheses, so fields are counted from the last ')'
+    bool read_process(int pid, Process& process) {
+        char path[32];
+        snprintf(path, sizeof(path), "%d/stat", pid);
+        int fd = openat(proc_fd_, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        ssize_t length;
+        do {
+            length = read(fd, buffer_, sizeof(buffer_) - 1);
+        } while (length < 0 && errno == EINTR);
+        close(fd);
+        if (length <= 0) return false;
+
+        const char* end = buffer_ + length;
+        const char* open_paren = static_cast<const char*>(std::memchr(buffer_, '(', length));
+        const char* close_paren = end;
+        while (close_paren > buffer_ && *(close_paren - 1) != ')') close_paren--;
+        if (!open_paren || close_paren <= open_paren + 1) return false;
+        close_paren--;
+
+        process.pid = pid;
+        size_t comm_length = std::min<size_t>(close_paren - open_paren - 1, sizeof(process.comm) - 1);
+        std::memcpy(process.comm, open_paren + 1, comm_length);
+        process.comm[comm_length] = '\0';
+
+        // Fields 3.. of proc(5): state is 3, utime 14, stime 15, starttime 22, rss 24
+        const char* p = ProcScan::skip_spaces(close_paren + 1, end);
+        if (p == end) return false;
+        process.state = *p;
+        int64_t fields[21] = {}; // Fields 4..24; priority and nice can be negative
+        p = ProcScan::skip_token(p, end);
+        for (int64_t& field : fields) {
+            p = ProcScan::parse_i64(p, end, field);
+            if (!p) return false;
+        }
+        process.ticks = static_cast<uint64_t>(fields[14 - 4] + fields[15 - 4]);
+        process.start_time = static_cast<uint64_t>(fields[22 - 4]);
+        process.rss_pages = fields[24 - 4] > 0 ? static_cast<uint64_t>(fields[24 - 4]) : 0;
+        return true;
+    }
+
+    const Process* find_previous(int pid) const {
+        auto it = std::lower_bound(previous_.begin(), previous_.end(), pid,
+                                   [](const Process& process, int value) { return process.pid < value; });
+        return it != previous_.end() && it->pid == pid ? &*it : nullptr;
+    }
+
+    // Bounded min-heap: the smallest of the K kept so far sits at the front
+    static bool greater(const Ranked& a, const Ranked& b) { return a.key > b.key; }
+
+    static void push_top(std::vector<Ranked>& heap, size_t k, Ranked ranked) {
+        if (k == 0) return;
+        if (heap.size() < k) {
+            heap.push_back(ranked);
+            std::push_heap(heap.begin(), heap.end(), greater);
+        } else if (ranked.key > heap.front().key) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            heap.back() = ranked;
+            std::push_heap(heap.begin(), heap.end(), greater);
+        }
+    }
+
+    void fill(std::vector<Ranked>& heap, std::vector<ProcessStats>& top) const {
+        std::sort_heap(heap.begin(), heap.end(), greater);
+        top.resize(heap.size());
+        for (size_t i = 0; i < heap.size(); i++) {
+            const Process& process = current_[heap[i].index];
+            ProcessStats& stats = top[i];
+            stats.pid = process.pid;
+            stats.state = process.state;
+            stats.command.assign(process.comm);
+            stats.cpu_percent = process.cpu_percent;
+            stats.rss_bytes = process.rss_pages * static_cast<uint64_t>(page_size_);
+            stats.memory_percent = total_pages_ > 0 ? process.rss_pages * 100.0 / total_pages_ : 0.0;
+            // The owner is the uid of its /proc directory; only looked up for the K kept
+            char path[16];
+            snprintf(path, sizeof(path), "%d", process.pid);
+            struct stat st;
+            stats.uid = fstatat(proc_fd_, path, &st, 0) == 0 ? st.st_uid : 0;
+        }
+    }
+
+    int proc_fd_ = -1;
+    long ticks_per_sec_;
+    long page_size_;
+    long total_pages_;
+    uint64_t previous_ns_ = 0;
+    std::vector<Process> previous_;
+    std::vector<Process> current_;
+    std::vector<Ranked> cpu_heap_;
+    std::vector<Ranked> memory_heap_;
+    char buffer_[1024];
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include "trace.h"
+
+enum class ProfileStage {
+    JOURNAL_FETCH,
+    FILE_READ,
+    PARSE,
+    FILTER,
+    OUTPUT,
+    HARDWARE,
+    UI_APPEND,
+    STAGE_COUNT
+};
+
+enum class ProfileCounter {
+    BYTES_READ,
+    LINES_SEEN,
+    LINES_PARSED,
+    PARSE_FAILURES,
+    ENTRIES_EMITTED,
+    COUNTER_COUNT
+};
+
+// Process-wide stage timers and counters for --profile. Disabled by default;
+// when compiled with ARCHLOG_NO_PROFILE the macros below expand to nothing.
+// Stage scopes double as --trace-out spans (see trace.h).
+class Profiler {
+public:
+    static void enable() {
+        start_ns_ = now_ns();
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static void add(ProfileCounter counter, uint64_t n) {
+        if (!enabled()) return;
+        counters_[static_cast<int>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static void record(ProfileStage stage, uint64_t ns) {
+        int index = static_cast<int>(stage);
+        stage_ns_[index].fetch_add(ns, std::memory_order_relaxed);
+        stage_calls_[index].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static uint64_t now_ns() { return Tracer::now_ns(); }
+
+    static const char* trace_name(ProfileStage stage) {
+        static const char* names[] = {"source fetch", "source fetch", "parse batch", "filter", "output flush",
+                                      "hardware sample", "ui append"};
+        return names[static_cast<int>(stage)];
+    }
+
+    static const char* trace_category(ProfileStage stage) {
+        static const char* categories[] = {"journal", "file", "parse", "filter", "output", "hardware", "ui"};
+        return categories[static_cast<int>(stage)];
+    }
+
+    // Allocation figures come from the binary's counting allocator, if any
+    static void print_summary(uint64_t allocations, uint64_t allocated_bytes) {
+        static const char* stage_names[] = {"journal fetch", "file read", "parse", "filter", "output", "hardware", "ui append"};
+        static const char* counter_names[] = {"bytes read", "lines seen", "lines parsed", "parse failures", "entries emitted"};
+
+        double wall_ms = (now_ns() - start_ns_) / 1e6;
+        std::fprintf(stderr, "\n=== Profile ===\n");
+        std::fprintf(stderr, "%-18s %8s %12s %8s\n", "stage", "calls", "time (ms)", "% wall");
+        for (int i = 0; i < static_cast<int>(ProfileStage::STAGE_COUNT); i++) {
+            uint64_t calls = stage_calls_[i].load(std::memory_order_relaxed);
+            if (calls == 0) continue;
+            double ms = stage_ns_[i].load(std::memory_order_relaxed) / 1e6;
+            std::fprintf(stderr, "%-18s %8llu %12.3f %7.1f%%\n", stage_names[i],
+                         static_cast<unsigned long long>(calls), ms, wall_ms > 0 ? ms * 100.0 / wall_ms : 0.0);
+        }
+        std::fprintf(stderr, "%-18s %8s %12.3f\n", "wall", "", wall_ms);
+
+        std::fprintf(stderr, "\n%-18s %14s\n", "counter", "value");
+        for (int i = 0; i < static_cast<int>(ProfileCounter::COUNTER_COUNT); i++) {
+            std::fprintf(stderr, "%-18s %14llu\n", counter_names[i],
+                         static_cast<unsigned long long>(counters_[i].load(std::memory_order_relaxed)));
+        }
+        std::fprintf(stderr, "%-18s %14llu\n", "allocations", static_cast<unsigned long long>(allocations));
+        std::fprintf(stderr, "%-18s %14llu\n", "bytes allocated", static_cast<unsigned long long>(allocated_bytes));
+    }
+
+private:
+    static std::atomic<bool> enabled_;
+    static uint64_t start_ns_;
+    static std::atomic<uint64_t> stage_ns_[static_cast<int>(ProfileStage::STAGE_COUNT)];
+    static std::atomic<uint64_t> stage_calls_[static_cast<int>(ProfileStage::STAGE_COUNT)];
+    static std::atomic<uint64_t> counters_[static_cast<int>(ProfileCounter::COUNTER_COUNT)];
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileStage stage)
+        : stage_(stage), start_(Profiler::enabled() || Tracer::enabled() ? Profiler::now_ns() : 0) {}
+    ~ProfileScope() {
+        if (!start_) return;
+        uint64_t end = Profiler::now_ns();
+        if (Profiler::enabled()) Profiler::record(stage_, end - start_);
+        Tracer::complete(Profiler::trace_name(stage_), Profiler::trace_category(stage_), start_, end);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileStage stage_;
+    uint64_t start_;
+};
+
+// Static member definitions
+std::atomic<bool> Profiler::enabled_{false};
+uint64_t Profiler::start_ns_ = 0;
+std::atomic<uint64_t> Profiler::stage_ns_[static_cast<int>(ProfileStage::STAGE_COUNT)];
+std::atomic<uint64_t> Profiler::stage_calls_[static_cast<int>(ProfileStage::STAGE_COUNT)];
+std::atomic<uint64_t> Profiler::counters_[static_cast<int>(ProfileCounter::COUNTER_COUNT)];
+
+#ifdef ARCHLOG_NO_PROFILE
+#define ARCHLOG_PROFILE_SCOPE(stage) do {} while (0)
+#define ARCHLOG_PROFILE_COUNT(counter, n) do { (void)sizeof(n); } while (0)
+#else
+#define ARCHLOG_PROFILE_CONCAT_(a, b) a##b
+#define ARCHLOG_PROFILE_CONCAT(a, b) ARCHLOG_PROFILE_CONCAT_(a, b)
+#define ARCHLOG_PROFILE_SCOPE(stage) ProfileScope ARCHLOG_PROFILE_CONCAT(profile_scope_, __LINE__)(stage)
+#define ARCHLOG_PROFILE_COUNT(counter, n) Profiler::add(counter, n)
+#endif
+
+#endif
@@ -0,0 +1,581 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "error_handler.h"
+#include "log_analyzer.h"
+#include "hardware_monitor.h"
+#include "stats_history.h"
+
+// Append-only recording of hardware samples and ingested log entries.
+//
+//   file    = "ARCHREC" version:u8 record*
+//   record  = kind:varint body
+//   SESSION = start_us:varint       absolute; resets every delta and dictionary below
+//   SAMPLE  = dt:zigzag value:zigzag{METRIC_COUNT}
+//   NAMES   = dt:zigzag cpu:string gpu:string
+//   LOGS    = dt:zigzag count:varint entry{count}
+//   entry   = level:id service:id shared:varint suffix:string message:string
+//   id      = varint index into the session's dictionary; index == size
+//             means a new string follows and is appended
+//   string  = length:varint bytes
+//
+// dt is microseconds since the previous record. Sample values are the
+// StatsHistory figures in hundredths, each delta-encoded against the same
+// figure in the previous sample, so a steady system costs a byte or two per
+// figure. Log timestamps share a prefix with the previous entry's. Every
+// open() starts a new SESSION, so appending to an existing recording needs
+// no state from it, and a record cut short by a crash is skipped up to the
+// SESSION that the next open() wrote.
+namespace RecordFormat {
+    static constexpr char MAGIC[7] = {'A', 'R', 'C', 'H', 'R', 'E', 'C'};
+    static constexpr uint8_t VERSION = 1;
+    static constexpr int METRIC_COUNT = StatsHistory::METRIC_COUNT;
+
+    enum Kind : uint64_t { SESSION = 0, SAMPLE = 1, NAMES = 2, LOGS = 3 };
+
+    inline void put_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    inline void put_zigzag(std::string& out, int64_t value) {
+        put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    inline void put_string(std::string& out, const std::string& text) {
+        put_varint(out, text.size());
+        out += text;
+    }
+
+    inline int64_t centi(double value) {
+        return std::isfinite(value) ? static_cast<int64_t>(std::llround(value * 100.0)) : 0;
+    }
+
+    // Inverse of StatsHistory::value_of for the recorded figures
+    inline void apply(HistoryMetric metric, double value, HardwareStats& stats) {
+        switch (metric) {
+            case HistoryMetric::CPU: stats.cpu_usage = value; break;
+            case HistoryMetric::MEMORY: stats.memory_usage = value; break;
+            case HistoryMetric::DISK: stats.disk_usage = value; break;
+            case HistoryMetric::DISK_READ: stats.disk_read = value; break;
+            case HistoryMetric::DISK_WRITE: stats.disk_write = value; break;
+            case HistoryMetric::DISK_BUSY: stats.disk_busy = value; break;
+            case HistoryMetric::GPU: stats.gpu_usage = value; break;
+            case HistoryMetric::LOAD: {
+                char load[32];
+                snprintf(load, sizeof(load), "%.2f", value);
+                stats.system_load = load;
+                break;
+            }
+            case HistoryMetric::CPU_TEMP: stats.cpu_temp = static_cast<int>(std::lround(value)); break;
+            case HistoryMetric::GPU_TEMP: stats.gpu_temp = static_cast<int>(std::lround(value)); break;
+            case HistoryMetric::NETWORK_RX: stats.network_rx = value; break;
+            case HistoryMetric::NETWORK_TX: stats.network_tx = value; break;
+            case HistoryMetric::CONNECTIONS: stats.active_connections = static_cast<int>(std::lround(value)); break;
+            default: break;
+        }
+    }
+}
+
+class Recorder {
+public:
+    Recorder() = default;
+    ~Recorder() { close(); }
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // The recorder --record opens; idle (every call a no-op) otherwise
+    static Recorder& shared() {
+        static Recorder recorder;
+        return recorder;
+    }
+
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        close_locked();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ErrorHandler::handle_file_error(path, "record to");
+            return false;
+        }
+        path_ = path;
+        record_.clear();
+        if (lseek(fd_, 0, SEEK_END) == 0) {
+            record_.append(RecordFormat::MAGIC, sizeof(RecordFormat::MAGIC));
+            record_ += static_cast<char>(RecordFormat::VERSION);
+        }
+        previous_us_ = now_us();
+        std::fill(previous_values_, previous_values_ + RecordFormat::METRIC_COUNT, 0);
+        dictionary_.clear();
+        previous_timestamp_.clear();
+        cpu_name_.clear();
+        gpu_name_.clear();
+        RecordFormat::put_varint(record_, RecordFormat::SESSION);
+        RecordFormat::put_varint(record_, static_cast<uint64_t>(previous_us_));
+        return flush_locked();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        close_locked();
+    }
+
+    bool is_open() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fd_ >= 0;
+    }
+
+    void record_sample(const HardwareStats& stats) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0) return;
+        record_.clear();
+        if (stats.cpu_name != cpu_name_ || stats.gpu_name != gpu_name_) {
+            cpu_name_ = stats.cpu_name;
+            gpu_name_ = stats.gpu_name;
+            begin(RecordFormat::NAMES);
+            RecordFormat::put_string(record_, cpu_name_);
+            RecordFormat::put_string(record_, gpu_name_);
+        }
+        begin(RecordFormat::SAMPLE);
+        for (int m = 0; m < RecordFormat::METRIC_COUNT; m++) {
+            int64_t value = RecordFormat::centi(StatsHistory::value_of(static_cast<HistoryMetric>(m), stats));
+            RecordFormat::put_zigzag(record_, value - previous_values_[m]);
+            previous_values_[m] = value;
+        }
+        flush_locked();
+    }
+
+    void record_logs(const std::vector<LogEntry>& entries) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0 || entries.empty()) return;
+        record_.clear();
+        begin(RecordFormat::LOGS);
+        RecordFormat::put_varint(record_, entries.size());
+        for (const auto& entry : entries) {
+            put_id(entry.level);
+            put_id(entry.service);
+            size_t shared = 0;
+            size_t limit = std::min(entry.timestamp.size(), previous_timestamp_.size());
+            while (shared < limit && entry.timestamp[shared] == previous_timestamp_[shared]) shared++;
+            RecordFormat::put_varint(record_, shared);
+            RecordFormat::put_varint(record_, entry.timestamp.size() - shared);
+            record_.append(entry.timestamp, shared, std::string::npos);
+            RecordFormat::put_string(record_, entry.message);
+            previous_timestamp_ = entry.timestamp;
+        }
+        flush_locked();
+    }
+
+    static int64_t now_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    // Services and levels repeat endlessly; ids stay below 128 (one byte)
+    // for the first 128 distinct strings
+    static constexpr size_t MAX_DICTIONARY = 4096;
+
+    void begin(RecordFormat::Kind kind) {
+        int64_t now = now_us();
+        RecordFormat::put_varint(record_, kind);
+        RecordFormat::put_zigzag(record_, now - previous_us_);
+        previous_us_ = now;
+    }
+
+    void put_id(const std::string& text) {
+        for (size_t i = 0; i < dictionary_.size(); i++) {
+            if (dictionary_[i] == text) {
+                RecordFormat::put_varint(record_, i);
+                return;
+            }
+        }
+        // A full dictionary would grow without bound on unique strings, so
+        // they are written inline as the "new" id every time without being kept
+        RecordFormat::put_varint(record_, dictionary_.size());
+        RecordFormat::put_string(record_, text);
+        if (dictionary_.size() < MAX_DICTIONARY) dictionary_.push_back(text);
+    }
+
+    // One write per record; O_APPEND keeps concurrent recorders' records whole
+    bool flush_locked() {
+        const char* data = record_.data();
+        size_t length = record_.size();
+        while (length > 0) {
+            ssize_t n = ::write(fd_, data, length);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ErrorHandler::handle_file_error(path_, "write recording");
+                close_locked();
+                return false;
+            }
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void close_locked() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    mutable std::mutex mutex_;
+    int fd_ = -1;
+    std::string path_;
+    std::string record_;
+    int64_t previous_us_ = 0;
+    int64_t previous_values_[RecordFormat::METRIC_COUNT] = {};
+    std::vector<std::string> dictionary_;
+    std::string previous_timestamp_;
+    std::string cpu_name_;
+    std::string gpu_name_;
+};
+
+struct ReplayEvent {
+    enum Kind { SAMPLE, LOGS };
+    Kind kind = SAMPLE;
+    int64_t time_us = 0;     // When it was recorded
+    bool new_session = false; // First event after a gap between recordings
+    HardwareStats stats;     // SAMPLE: the recorded figures and names
+    std::vector<LogEntry> logs;
+};
+
+// Reads a recording back one event at a time, holding only the records not
+// yet consumed (a chunk or two) in memory
+class Replayer {
+public:
+    Replayer() = default;
+    ~Replayer() { close(); }
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            ErrorHandler::handle_file_error(path, "replay");
+            return false;
+        }
+        const size_t header = sizeof(RecordFormat::MAGIC) + 1;
+        while (data_.size() < header && fill()) {}
+        if (data_.size() < header || std::memcmp(data_.data(), RecordFormat::MAGIC, sizeof(RecordFormat::MAGIC)) != 0 ||
+            static_cast<uint8_t>(data_[sizeof(RecordFormat::MAGIC)]) != RecordFormat::VERSION) {
+            ErrorHandler::log_error("Not an archlog recording: " + path, ErrorLevel::ERROR);
+            close();
+            return false;
+        }
+        position_ = header;
+        return true;
+    }
+
+    // False at the end of the recording. A record cut short at the end is
+    // dropped; a damaged one elsewhere (a crashed writer followed by a new
+    // session) is skipped up to the next SESSION record.
+    bool next(ReplayEvent& event) {
+        event.new_session = false;
+        while (fd_ >= 0) {
+            if (position_ == data_.size() && !fill()) return false;
+
+            // Records are parsed from buffered bytes only; one that runs past
+            // them is parsed again once more of the file is read
+            size_t start = position_;
+            int64_t time_us = time_us_;
+            int64_t values[RecordFormat::METRIC_COUNT];
+            std::copy(values_, values_ + RecordFormat::METRIC_COUNT, values);
+            size_t dictionary_size = dictionary_.size();
+            timestamp_mark_.assign(timestamp_);
+            short_ = false;
+
+            Parsed parsed = parse_record(event);
+            if (parsed == Parsed::EVENT) return true;
+            if (parsed == Parsed::STATE) continue;
+
+            position_ = start;
+            time_us_ = time_us;
+            std::copy(values, values + RecordFormat::METRIC_COUNT, values_);
+            dictionary_.resize(dictionary_size);
+            timestamp_.assign(timestamp_mark_);
+            if (short_ && data_.size() - start < MAX_RECORD_BYTES && fill()) continue;
+            if (short_ && eof_) {
+                ErrorHandler::log_error("Recording ends in an incomplete record at byte " +
+                                        std::to_string(offset_ + position_), ErrorLevel::WARNING);
+                return false;
+            }
+            if (!resync(start)) return false;
+        }
+        return false;
+    }
+
+private:
+    enum class Parsed { EVENT, STATE, BAD };
+
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+    static constexpr size_t MAX_RECORD_BYTES = 64 * 1024 * 1024; // Larger means a damaged length
+    static constexpr size_t MAX_VARINT_BYTES = 10;
+    static constexpr int64_t MIN_TIME_US = 946684800LL * 1000000;  // 2000-01-01
+    static constexpr int64_t MAX_CLOCK_SKEW_US = 86400LL * 1000000; // Recordings from a day ahead
+
+    Parsed parse_record(ReplayEvent& event) {
+        uint64_t kind;
+        if (!get_varint(kind)) return Parsed::BAD;
+        if (kind == RecordFormat::SESSION) {
+            uint64_t start_us;
+            if (!get_varint(start_us) || !plausible_time(static_cast<int64_t>(start_us))) return Parsed::BAD;
+            time_us_ = static_cast<int64_t>(start_us);
+            std::fill(values_, values_ + RecordFormat::METRIC_COUNT, 0);
+            dictionary_.clear();
+            timestamp_.clear();
+            event.new_session = true;
+            return Parsed::STATE;
+        }
+        if (kind != RecordFormat::NAMES && kind != RecordFormat::SAMPLE && kind != RecordFormat::LOGS) {
+            return Parsed::BAD;
+        }
+
+        int64_t delta;
+        if (!get_zigzag(delta) || !plausible_time(time_us_ + delta)) return Parsed::BAD;
+        time_us_ += delta;
+        event.time_us = time_us_;
+        if (kind == RecordFormat::NAMES) {
+            if (!get_string(cpu_pending_) || !get_string(gpu_pending_)) return Parsed::BAD;
+            cpu_name_.swap(cpu_pending_);
+            gpu_name_.swap(gpu_pending_);
+            return Parsed::STATE;
+        }
+        if (kind == RecordFormat::SAMPLE) {
+            for (int m = 0; m < RecordFormat::METRIC_COUNT; m++) {
+                int64_t value_delta;
+                if (!get_zigzag(value_delta)) return Parsed::BAD;
+                values_[m] += value_delta;
+                RecordFormat::apply(static_cast<HistoryMetric>(m), values_[m] / 100.0, event.stats);
+            }
+            event.kind = ReplayEvent::SAMPLE;
+            event.stats.cpu_name = cpu_name_;
+            event.stats.gpu_name = gpu_name_;
+            return Parsed::EVENT;
+        }
+        if (!read_logs(event.logs)) return Parsed::BAD;
+        event.kind = ReplayEvent::LOGS;
+        return Parsed::EVENT;
+    }
+
+    // Skips a damaged record: the next zero byte followed by a plausible
+    // start time is taken for a SESSION record and parsing resumes there
+    bool resync(size_t bad) {
+        uint64_t skipped_from = offset_ + bad;
+        position_ = bad + 1;
+        while (true) {
+            while (position_ < data_.size() && data_[position_] != RecordFormat::SESSION) position_++;
+            if (data_.size() - position_ < 1 + MAX_VARINT_BYTES && !eof_) {
+                fill();
+                continue;
+            }
+            if (position_ >= data_.size()) {
+                ErrorHandler::log_error("Recording is damaged from byte " + std::to_string(skipped_from) +
+                                        " to its end", ErrorLevel::WARNING);
+                return false;
+            }
+            size_t candidate = position_++;
+            uint64_t start_us;
+            if (get_varint(start_us) && plausible_time(static_cast<int64_t>(start_us))) {
+                position_ = candidate;
+                ErrorHandler::log_error("Recording is damaged at byte " + std::to_string(skipped_from) + ", skipped " +
+                                        std::to_string(offset_ + candidate - skipped_from) + " bytes to the next session",
+                                        ErrorLevel::WARNING);
+                return true;
+            }
+            position_ = candidate + 1;
+        }
+    }
+
+    // Drops the consumed bytes before position_ and appends the next chunk
+    bool fill() {
+        if (fd_ < 0 || eof_) return false;
+        data_.erase(0, position_);
+        offset_ += position_;
+        position_ = 0;
+        size_t length = data_.size();
+        data_.resize(length + CHUNK_BYTES);
+        ssize_t n;
+        do {
+            n = ::read(fd_, &data_[length], CHUNK_BYTES);
+        } while (n < 0 && errno == EINTR);
+        data_.resize(length + (n > 0 ? static_cast<size_t>(n) : 0));
+        if (n <= 0) {
+            if (n < 0) ErrorHandler::handle_system_error("read recording", errno);
+            eof_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        data_.clear();
+        position_ = 0;
+        offset_ = 0;
+        eof_ = false;
+    }
+
+    static bool plausible_time(int64_t time_us) {
+        return time_us >= MIN_TIME_US && time_us <= Recorder::now_us() + MAX_CLOCK_SKEW_US;
+    }
+
+    bool read_logs(std::vector<LogEntry>& logs) {
+        uint64_t count;
+        if (!get_varint(count)) return false;
+        if (count > data_.size() - position_) return need_more(); // Every entry takes at least a byte
+        logs.resize(static_cast<size_t>(count));
+        for (auto& entry : logs) {
+            uint64_t shared, suffix;
+            if (!get_id(entry.level) || !get_id(entry.service) || !get_varint(shared) || !get_varint(suffix) ||
+                shared > timestamp_.size()) {
+                return false;
+            }
+            if (suffix > data_.size() - position_) return need_more();
+            timestamp_.resize(static_cast<size_t>(shared));
+            timestamp_.append(data_, position_, static_cast<size_t>(suffix));
+            position_ += static_cast<size_t>(suffix);
+            entry.timestamp = timestamp_;
+            if (!get_string(entry.message)) return false;
+        }
+        return true;
+    }
+
+    // The buffered bytes ran out mid-record: not damage unless the file has too
+    bool need_more() {
+        short_ = true;
+        return false;
+    }
+
+    bool get_varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position_ >= data_.size()) return need_more();
+            uint8_t byte = static_cast<uint8_t>(data_[position_++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool get_zigzag(int64_t& value) {
+        uint64_t raw;
+        if (!get_varint(raw)) return false;
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+
+    bool get_string(std::string& text) {
+        uint64_t length;
+        if (!get_varint(length)) return false;
+        if (length > data_.size() - position_) return need_more();
+        text.assign(data_, position_, static_cast<size_t>(length));
+        position_ += static_cast<size_t>(length);
+        return true;
+    }
+
+    bool get_id(std::string& text) {
+        uint64_t id;
+        if (!get_varint(id)) return false;
+        if (id < dictionary_.size()) {
+            text = dictionary_[static_cast<size_t>(id)];
+            return true;
+        }
+        if (id != dictionary_.size() || !get_string(text)) return false;
+        if (dictionary_.size() < MAX_DICTIONARY) dictionary_.push_back(text);
+        return true;
+    }
+
+    static constexpr size_t MAX_DICTIONARY = 4096; // Must match Recorder's
+
+    int fd_ = -1;
+    std::string data_;     // Unconsumed bytes, starting at file offset offset_
+    size_t position_ = 0;  // Into data_
+    uint64_t offset_ = 0;
+    bool eof_ = false;
+    bool short_ = false;   // The last parse failed for want of buffered bytes
+    int64_t time_us_ = 0;
+    int64_t values_[RecordFormat::METRIC_COUNT] = {};
+    std::vector<std::string> dictionary_;
+    std::string timestamp_;
+    std::string timestamp_mark_; // timestamp_ before the record being parsed
+    std::string cpu_name_ = "Unknown";
+    std::string gpu_name_ = "Unknown";
+    std::string cpu_pending_;
+    std::string gpu_pending_;
+};
+
+// Paces replayed events to their recorded spacing divided by speed; speed 0
+// replays as fast as possible. Each recording session restarts the clock, so
+// the time between two recordings is not waited out.
+class ReplayClock {
+public:
+    // With a running flag, waits wake up within a slice of it being cleared
+    explicit ReplayClock(double speed, const std::atomic<bool>* running = nullptr)
+        : speed_(speed), running_(running) {}
+
+    void wait(const ReplayEvent& event) {
+        if (speed_ <= 0.0) return;
+        auto now = std::chrono::steady_clock::now();
+        if (!started_ || event.new_session) {
+            started_ = true;
+            origin_us_ = event.time_us;
+            origin_ = now;
+            return;
+        }
+        auto due = origin_ + std::chrono::microseconds(
+                                 static_cast<int64_t>((event.time_us - origin_us_) / speed_));
+        if (!running_) {
+            if (due > now) std::this_thread::sleep_until(due);
+            return;
+        }
+        while (running_->load() && due > now) {
+            std::this_thread::sleep_until(std::min(due, now + std::chrono::milliseconds(WAIT_SLICE_MS)));
+            now = std::chrono::steady_clock::now();
+        }
+    }
+
+    // "2x", "0.5x", "10", or "max" for 0; -1 when malformed
+    static double parse_speed(const std::string& text) {
+        if (text == "max") return 0.0;
+        char* end = nullptr;
+        double speed = std::strtod(text.c_str(), &end);
+        if (end == text.c_str() || !(speed > 0.0) || !std::isfinite(speed)) return -1.0;
+        if (*end == 'x') end++;
+        return *end == '\0' ? speed : -1.0;
+    }
+
+private:
+    static constexpr int WAIT_SLICE_MS = 100;
+
+    double speed_;
+    const std::atomic<bool>* running_;
+    bool started_ = false;
+    int64_t origin_us_ = 0;
+    std::chrono::steady_clock::time_point origin_;
+};
+
+#endif
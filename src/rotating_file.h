@@ -0,0 +1,308 @@
+#ifndef ROTATING_FILE_H
+#define ROTATING_FILE_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <spawn.h>
+#include <signal.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "error_handler.h"
+
+extern char** environ;
+
+struct RotationPolicy {
+    uint64_t max_bytes = 16 * 1024 * 1024; // 0 = no size limit
+    int64_t max_age_seconds = 24 * 3600;   // 0 = no time limit
+    size_t keep = 8;                       // Closed segments kept, compressed or not
+    bool compress = true;                  // gzip closed segments in the background
+};
+
+// Append-only log file split into segments named
+// <prefix>-YYYYmmdd-HHMMSS.mmm.log in one directory. A segment is closed when
+// it reaches max_bytes or max_age_seconds, handed to a gzip child that runs
+// on its own, and the oldest segments beyond keep are deleted. Only one fd is
+// open at a time; the owner is a single thread (the StructuredLogger writer),
+// so rotating never blocks whoever produced the data. The process holding
+// <prefix>.lock owns the prefix and prunes its segments; another process
+// logging to the same directory holds <prefix>.<pid>.lock and writes and
+// prunes <prefix>.<pid>-* instead of deleting the owner's open segment. Once
+// that process is gone, the owner deletes its leftover segments.
+class RotatingFile {
+public:
+    RotatingFile(std::string directory, std::string prefix, RotationPolicy policy = RotationPolicy())
+        : directory_(std::move(directory)), prefix_(std::move(prefix)), policy_(policy) {}
+
+    // Finished compressors are reaped; running ones finish on their own
+    ~RotatingFile() {
+        if (fd_ >= 0) close(fd_);
+        if (lock_fd_ >= 0) close(lock_fd_);
+        reap_compressors();
+    }
+
+    RotatingFile(const RotatingFile&) = delete;
+    RotatingFile& operator=(const RotatingFile&) = delete;
+
+    void set_policy(const RotationPolicy& policy) { policy_ = policy; }
+
+    const std::string& path() const { return path_; }
+
+    bool write(const char* data, size_t length) {
+        reap_compressors();
+        if (fd_ >= 0 && segment_full(length)) rotate();
+        if (fd_ < 0 && !open_segment()) return false;
+
+        while (length > 0) {
+            ssize_t n = ::write(fd_, data, length);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ErrorHandler::handle_system_error("write " + path_, errno);
+                close(fd_); // The next write starts a fresh segment
+                fd_ = -1;
+                return false;
+            }
+            data += n;
+            length -= static_cast<size_t>(n);
+            bytes_ += static_cast<uint64_t>(n);
+        }
+        return true;
+    }
+
+private:
+    bool segment_full(size_t incoming) const {
+        if (policy_.max_bytes > 0 && bytes_ > 0 && bytes_ + incoming > policy_.max_bytes) return true;
+        return policy_.max_age_seconds > 0 && time(nullptr) - opened_ >= policy_.max_age_seconds;
+    }
+
+    void rotate() {
+        close(fd_);
+        fd_ = -1;
+        if (policy_.compress && !gzip_missing_) compress(path_);
+        open_segment();
+    }
+
+    bool open_segment() {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        struct tm local;
+        localtime_r(&now.tv_sec, &local);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+        char millis[8];
+        snprintf(millis, sizeof(millis), ".%03d", static_cast<int>(now.tv_nsec / 1000000));
+
+        mkdir(directory_.c_str(), 0700);
+        if (segment_prefix_.empty()) claim_prefix();
+        path_ = directory_ + "/" + segment_prefix_ + "-" + stamp + millis + ".log";
+        fd_ = open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+        if (fd_ < 0) {
+            // Reported once per outage, not once per batch
+            if (!open_failed_) ErrorHandler::handle_file_error(path_, "open log segment");
+            open_failed_ = true;
+            return false;
+        }
+        open_failed_ = false;
+        struct stat st;
+        bytes_ = fstat(fd_, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        opened_ = now.tv_sec;
+        prune();
+        return true;
+    }
+
+    // The lock is held for the life of this object, so a crashed owner
+    // frees the prefix for the next process
+    void claim_prefix() {
+        lock_fd_ = lock(prefix_);
+        if (lock_fd_ >= 0) {
+            segment_prefix_ = prefix_;
+            return;
+        }
+        segment_prefix_ = prefix_ + "." + std::to_string(getpid());
+        lock_fd_ = lock(segment_prefix_); // Tells the owner this writer is still running
+    }
+
+    bool owner() const { return segment_prefix_ == prefix_; }
+
+    // fd holding an exclusive flock on <name>.lock, or -1 when it is held elsewhere
+    int lock(const std::string& name) const {
+        std::string lock_path = directory_ + "/" + name + ".lock";
+        int fd = open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    // gzip replaces the segment with segment.gz when it is done
+    void compress(const std::string& segment) {
+        std::string program = "gzip";
+        std::string quiet = "-q";
+        std::string end_of_options = "--";
+        std::string file = segment;
+        char* argv[] = {&program[0], &quiet[0], &end_of_options[0], &file[0], nullptr};
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        pid_t pid = -1;
+        int error = posix_spawnp(&pid, program.c_str(), &actions, nullptr, argv, environ);
+        posix_spawn_file_actions_destroy(&actions);
+        if (error != 0) {
+            ErrorHandler::log_error("Cannot start gzip, log segments stay uncompressed", ErrorLevel::WARNING);
+            gzip_missing_ = true;
+            return;
+        }
+        compressors_.push_back({pid, segment.substr(directory_.size() + 1)});
+    }
+
+    void reap_compressors() {
+        compressors_.erase(std::remove_if(compressors_.begin(), compressors_.end(), [](const Compressor& compressor) {
+            int status;
+            return waitpid(compressor.pid, &status, WNOHANG) != 0;
+        }), compressors_.end());
+    }
+
+    bool compressing(const std::string& segment) const {
+        for (const auto& compressor : compressors_) {
+            if (compressor.segment == segment) return true;
+        }
+        return false;
+    }
+
+    // Timestamped names sort in age order; the open segment is always newest.
+    // A segment counts once whether it is .log, .log.gz or both mid-gzip, and
+    // one whose gzip is still running is left for a later prune.
+    void prune() {
+        DIR* dir = opendir(directory_.c_str());
+        if (!dir) return;
+        std::string open_name = path_.substr(directory_.size() + 1);
+        std::vector<std::string> closed; // As <segment>.log
+        std::vector<std::pair<std::string, std::string>> others; // Other writers' <prefix>.<pid> and file names
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (owner()) {
+                std::string other = other_writer(name);
+                if (!other.empty()) others.emplace_back(std::move(other), name);
+            }
+            if (ends_with(name, ".log.gz")) name.resize(name.size() - 3);
+            if (!is_segment(name, segment_prefix_) || name == open_name) continue;
+            closed.push_back(std::move(name));
+        }
+        closedir(dir);
+        prune_departed(others);
+
+        std::sort(closed.begin(), closed.end());
+        closed.erase(std::unique(closed.begin(), closed.end()), closed.end());
+        size_t excess = closed.size() > policy_.keep ? closed.size() - policy_.keep : 0;
+        for (size_t i = 0; i < closed.size() && excess > 0; i++) {
+            if (compressing(closed[i])) continue;
+            std::string path = directory_ + "/" + closed[i];
+            unlink(path.c_str());
+            unlink((path + ".gz").c_str());
+            excess--;
+        }
+    }
+
+    // <prefix>.<pid> when name is one of that writer's segments or its lock
+    std::string other_writer(const std::string& name) const {
+        size_t start = prefix_.size() + 1;
+        if (name.size() <= start || name.compare(0, prefix_.size(), prefix_) != 0 || name[prefix_.size()] != '.') {
+            return "";
+        }
+        size_t end = start;
+        while (end < name.size() && name[end] >= '0' && name[end] <= '9') end++;
+        if (end == start) return "";
+        std::string other = name.substr(0, end);
+        bool lock_file = name.compare(end, std::string::npos, ".lock") == 0;
+        std::string segment = ends_with(name, ".log.gz") ? name.substr(0, name.size() - 3) : name;
+        return lock_file || is_segment(segment, other) ? other : "";
+    }
+
+    // Writers whose <prefix>.<pid>.lock is free have exited, and no later
+    // process reuses their name, so their segments go now. Without a lock
+    // file the pid itself is checked.
+    void prune_departed(std::vector<std::pair<std::string, std::string>>& others) {
+        std::sort(others.begin(), others.end());
+        for (size_t i = 0; i < others.size();) {
+            const std::string other = others[i].first;
+            const std::string lock_name = other + ".lock";
+            size_t end = i;
+            bool has_lock = false;
+            for (; end < others.size() && others[end].first == other; end++) {
+                if (others[end].second == lock_name) has_lock = true;
+            }
+            int fd = -1;
+            bool gone;
+            if (has_lock) {
+                fd = lock(other);
+                gone = fd >= 0;
+            } else {
+                pid_t pid = static_cast<pid_t>(std::atol(other.c_str() + prefix_.size() + 1));
+                gone = kill(pid, 0) != 0 && errno == ESRCH;
+            }
+            if (gone) {
+                // The lock file goes last, while still held
+                for (size_t j = i; j < end; j++) {
+                    if (others[j].second != lock_name) unlink((directory_ + "/" + others[j].second).c_str());
+                }
+                if (has_lock) unlink((directory_ + "/" + lock_name).c_str());
+            }
+            if (fd >= 0) close(fd);
+            i = end;
+        }
+    }
+
+    // <prefix>-YYYYmmdd-HHMMSS.mmm.log exactly, so another process's
+    // <prefix>.<pid>-* segments never match the owner's prefix
+    static bool is_segment(const std::string& name, const std::string& prefix) {
+        static const char shape[] = "DDDDDDDD-DDDDDD.DDD.log";
+        size_t start = prefix.size() + 1;
+        if (name.size() != start + sizeof(shape) - 1 || name.compare(0, prefix.size(), prefix) != 0 ||
+            name[prefix.size()] != '-') {
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(shape) - 1; i++) {
+            char c = name[start + i];
+            if (shape[i] == 'D' ? (c < '0' || c > '9') : c != shape[i]) return false;
+        }
+        return true;
+    }
+
+    static bool ends_with(const std::string& text, const char* suffix) {
+        size_t length = std::char_traits<char>::length(suffix);
+        return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+
+    struct Compressor {
+        pid_t pid;
+        std::string segment; // File name of the .log being gzipped
+    };
+
+    std::string directory_;
+    std::string prefix_;
+    std::string segment_prefix_; // prefix_, or prefix_.<pid> when another process owns it
+    int lock_fd_ = -1;
+    RotationPolicy policy_;
+    std::string path_;
+    int fd_ = -1;
+    uint64_t bytes_ = 0;
+    time_t opened_ = 0;
+    bool open_failed_ = false;
+    bool gzip_missing_ = false;
+    std::vector<Compressor> compressors_;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <dirent.h>
+#include "proc_reader.h"
+
+enum class SensorKind {
+    CPU_PACKAGE,
+    CPU_CORE,
+    GPU,
+    STORAGE,
+    OTHER
+};
+
+struct TemperatureReading {
+    std::string label; // "<chip> <input label>", e.g. "coretemp Package id 0", "nvme Composite"
+    SensorKind kind = SensorKind::OTHER;
+    double celsius = 0.0;
+    bool valid = false; // False when the last read failed (device asleep or gone)
+};
+
+// Temperature inputs under /sys/class/hwmon and /sys/class/thermal,
+// classified by driver name and polled through cached descriptors. The hwmon
+// directory is re-checked every RESCAN_POLLS polls, and the inputs are
+// rebuilt when a driver was loaded or removed or hwmonN was renumbered.
+class SensorRegistry {
+public:
+    static constexpr int RESCAN_POLLS = 30;
+
+    SensorRegistry() { scan(); }
+
+    SensorRegistry(const SensorRegistry&) = delete;
+    SensorRegistry& operator=(const SensorRegistry&) = delete;
+
+    const std::vector<TemperatureReading>& readings() const { return readings_; }
+
+    // Re-reads every known input; no allocations unless the hwmon set changed
+    void poll() {
+        if (++polls_ % RESCAN_POLLS == 0 && hwmon_signature() != signature_) scan();
+        char value[32];
+        for (size_t i = 0; i < inputs_.size(); i++) {
+            int64_t millidegrees = 0;
+            long length = inputs_[i]->read(value, sizeof(value));
+            readings_[i].valid = length > 0 && ProcScan::parse_i64(value, value + length, millidegrees);
+            readings_[i].celsius = readings_[i].valid ? millidegrees / 1000.0 : 0.0;
+        }
+    }
+
+    // Hottest CPU package, else hottest core, else the first thermal zone
+    int cpu_temperature() const {
+        double package = hottest(SensorKind::CPU_PACKAGE);
+        if (package > 0.0) return static_cast<int>(package);
+        double core = hottest(SensorKind::CPU_CORE);
+        if (core > 0.0) return static_cast<int>(core);
+        for (const auto& reading : readings_) {
+            if (reading.kind == SensorKind::OTHER && reading.valid && reading.label.compare(0, 8, "thermal ") == 0) {
+                return static_cast<int>(reading.celsius);
+            }
+        }
+        return 0;
+    }
+
+    // First GPU input (edge temperature on amdgpu), 0 without a GPU sensor
+    int gpu_temperature() const {
+        for (const auto& reading : readings_) {
+            if (reading.kind == SensorKind::GPU && reading.valid) return static_cast<int>(reading.celsius);
+        }
+        return 0;
+    }
+
+    bool has(SensorKind kind) const {
+        for (const auto& reading : readings_) {
+            if (reading.kind == kind) return true;
+        }
+        return false;
+    }
+
+    static const char* kind_name(SensorKind kind) {
+        switch (kind) {
+            case SensorKind::CPU_PACKAGE: return "cpu-package";
+            case SensorKind::CPU_CORE: return "cpu-core";
+            case SensorKind::GPU: return "gpu";
+            case SensorKind::STORAGE: return "storage";
+            default: return "other";
+        }
+    }
+
+private:
+    static SensorKind classify(const std::string& chip, const std::string& label) {
+        if (chip == "coretemp") {
+            return label.compare(0, 7, "Package") == 0 ? SensorKind::CPU_PACKAGE : SensorKind::CPU_CORE;
+        }
+        if (chip == "k10temp" || chip == "zenpower") {
+            // Tctl/Tdie describe the package, Tccd<N> one core complex
+            return label.compare(0, 4, "Tccd") == 0 ? SensorKind::CPU_CORE : SensorKind::CPU_PACKAGE;
+        }
+        if (chip == "cpu_thermal" || chip == "x86_pkg_temp") return SensorKind::CPU_PACKAGE;
+        if (chip == "amdgpu" || chip == "radeon" || chip == "nouveau" || chip == "i915" || chip == "xe") {
+            return SensorKind::GPU;
+        }
+        if (chip == "nvme" || chip == "drivetemp") return SensorKind::STORAGE;
+        return SensorKind::OTHER;
+    }
+
+    void scan() {
+        inputs_.clear();
+        readings_.clear();
+        signature_ = hwmon_signature();
+        std::vector<std::string> devices;
+        DIR* dir = opendir("/sys/class/hwmon");
+        if (dir) {
+            while (struct dirent* entry = readdir(dir)) {
+                if (entry->d_name[0] != '.') devices.push_back(entry->d_name);
+            }
+            closedir(dir);
+        }
+        std::sort(devices.begin(), devices.end());
+
+        std::vector<std::string> hwmon_names;
+        for (const auto& device : devices) {
+            std::string path = "/sys/class/hwmon/" + device;
+            std::string chip;
+            std::ifstream name_file(path + "/name");
+            std::getline(name_file, chip);
+            add_hwmon(path, chip);
+            hwmon_names.push_back(chip);
+        }
+        add_thermal_zones(hwmon_names);
+    }
+
+    // Entry names and inode numbers: a reloaded driver gets new sysfs nodes
+    // even when its hwmonN name is reused
+    static uint64_t hwmon_signature() {
+        uint64_t hash = 14695981039346656037ULL;
+        DIR* dir = opendir("/sys/class/hwmon");
+        if (!dir) return 0;
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            uint64_t entry_hash = entry->d_ino;
+            for (const char* p = entry->d_name; *p; p++) entry_hash = (entry_hash ^ static_cast<unsigned char>(*p)) * 1099511628211ULL;
+            hash += entry_hash; // Order independent
+        }
+        closedir(dir);
+        return hash;
+    }
+
+    void add_hwmon(const std::string& path, const std::string& chip) {
+        std::vector<std::string> inputs;
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return;
+        while (struct dirent* entry = readdir(dir)) {
+            const char* name = entry->d_name;
+            size_t length = std::strlen(name);
+            if (length > 10 && std::strncmp(name, "temp", 4) == 0 && std::strcmp(name + length - 6, "_input") == 0) {
+                inputs.push_back(std::string(name, length - 6));
+            }
+        }
+        closedir(dir);
+        // temp2 before temp10
+        std::sort(inputs.begin(), inputs.end(), [](const std::string& a, const std::string& b) {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+
+        for (const auto& input : inputs) {
+            std::string label;
+            std::ifstream label_file(path + "/" + input + "_label");
+            if (!std::getline(label_file, label) || label.empty()) label = input;
+            add(path + "/" + input + "_input", chip + " " + label, classify(chip, label));
+        }
+    }
+
+    // Zones the kernel does not already export through hwmon (acpitz usually is)
+    void add_thermal_zones(const std::vector<std::string>& hwmon_names) {
+        DIR* dir = opendir("/sys/class/thermal");
+        if (!dir) return;
+        std::vector<std::string> zones;
+        while (struct dirent* entry = readdir(dir)) {
+            if (std::strncmp(entry->d_name, "thermal_zone", 12) == 0) zones.push_back(entry->d_name);
+        }
+        closedir(dir);
+        std::sort(zones.begin(), zones.end(), [](const std::string& a, const std::string& b) {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+
+        for (const auto& zone : zones) {
+            std::string path = "/sys/class/thermal/" + zone;
+            std::string type;
+            std::ifstream type_file(path + "/type");
+            std::getline(type_file, type);
+            if (std::find(hwmon_names.begin(), hwmon_names.end(), type) != hwmon_names.end()) continue;
+            add(path + "/temp", "thermal " + (type.empty() ? zone : type), classify(type, ""));
+        }
+    }
+
+    void add(const std::string& path, const std::string& label, SensorKind kind) {
+        auto input = std::make_unique<ProcFile>(path.c_str());
+        if (!input->is_open()) return;
+        TemperatureReading reading;
+        reading.label = label;
+        reading.kind = kind;
+        readings_.push_back(reading);
+        inputs_.push_back(std::move(input));
+    }
+
+    double hottest(SensorKind kind) const {
+        double hottest = 0.0;
+        for (const auto& reading : readings_) {
+            if (reading.kind == kind && reading.valid && reading.celsius > hottest) hottest = reading.celsius;
+        }
+        return hottest;
+    }
+
+    std::vector<std::unique_ptr<ProcFile>> inputs_;
+    std::vector<TemperatureReading> readings_;
+    uint64_t signature_ = 0;
+    uint64_t polls_ = 0;
+};
+
+#endif
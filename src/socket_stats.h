@@ -0,0 +1,150 @@
+#ifndef SOCKET_STATS_H
+#define SOCKET_STATS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+
+// Sockets per TCP state (index TCP_ESTABLISHED .. TCP_CLOSING; UDP sockets
+// report TCP_ESTABLISHED when connected and TCP_CLOSE when only bound)
+struct SocketStateCounts {
+    static constexpr int STATES = TCP_CLOSING + 1;
+    uint32_t states[STATES] = {};
+    uint32_t total = 0;
+};
+
+struct ListeningSocket {
+    bool udp = false;
+    int family = AF_INET;
+    std::string address;
+    uint16_t port = 0;
+    uint32_t uid = 0;
+    uint64_t inode = 0;
+};
+
+// Enumerates sockets with NETLINK_SOCK_DIAG dumps. The state mask travels
+// with the request, so the kernel skips non-matching sockets and the cost
+// follows the number of matches rather than every socket on the host, unlike
+// /proc/net/tcp which formats the whole table on each read. buf is scratch
+// space for the replies; 16 KiB lets the kernel batch many sockets per recv.
+class SocketCollector {
+public:
+    static constexpr uint32_t ALL_STATES = (1U << SocketStateCounts::STATES) - 1;
+
+    SocketCollector() { fd_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG); }
+
+    ~SocketCollector() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    SocketCollector(const SocketCollector&) = delete;
+    SocketCollector& operator=(const SocketCollector&) = delete;
+
+    bool is_open() const { return fd_ >= 0; }
+
+    // Adds the sockets of one family (AF_INET/AF_INET6) and protocol
+    // (IPPROTO_TCP/IPPROTO_UDP) whose state bit is set in state_mask
+    bool count(int family, int protocol, uint32_t state_mask, SocketStateCounts& counts, char* buf, size_t capacity) {
+        return dump(family, protocol, state_mask, buf, capacity, [&](const struct inet_diag_msg* message) {
+            if (message->idiag_state < SocketStateCounts::STATES) counts.states[message->idiag_state]++;
+            counts.total++;
+        });
+    }
+
+    // TCP and UDP over IPv4 and IPv6 together
+    bool count_all(uint32_t state_mask, SocketStateCounts& tcp, SocketStateCounts& udp, char* buf, size_t capacity) {
+        bool ok = true;
+        for (int family : {AF_INET, AF_INET6}) {
+            ok = count(family, IPPROTO_TCP, state_mask, tcp, buf, capacity) && ok;
+            ok = count(family, IPPROTO_UDP, state_mask, udp, buf, capacity) && ok;
+        }
+        return ok;
+    }
+
+    // TCP listeners and bound but unconnected UDP sockets, like `ss -tuln`
+    bool listening(std::vector<ListeningSocket>& sockets, char* buf, size_t capacity) {
+        sockets.clear();
+        bool ok = true;
+        for (int family : {AF_INET, AF_INET6}) {
+            for (int protocol : {IPPROTO_TCP, IPPROTO_UDP}) {
+                uint32_t states = protocol == IPPROTO_TCP ? 1U << TCP_LISTEN : 1U << TCP_CLOSE;
+                ok = dump(family, protocol, states, buf, capacity, [&](const struct inet_diag_msg* message) {
+                    ListeningSocket socket;
+                    socket.udp = protocol == IPPROTO_UDP;
+                    socket.family = family;
+                    char address[INET6_ADDRSTRLEN];
+                    if (inet_ntop(family, message->id.idiag_src, address, sizeof(address))) socket.address = address;
+                    socket.port = ntohs(message->id.idiag_sport);
+                    socket.uid = message->idiag_uid;
+                    socket.inode = message->idiag_inode;
+                    sockets.push_back(socket);
+                }) && ok;
+            }
+        }
+        return ok;
+    }
+
+    static const char* state_name(int state) {
+        static const char* names[] = {"UNKNOWN", "ESTABLISHED", "SYN-SENT", "SYN-RECV", "FIN-WAIT-1", "FIN-WAIT-2",
+                                      "TIME-WAIT", "CLOSE", "CLOSE-WAIT", "LAST-ACK", "LISTEN", "CLOSING"};
+        return state >= 0 && state < SocketStateCounts::STATES ? names[state] : "UNKNOWN";
+    }
+
+private:
+    template <typename Fn>
+    bool dump(int family, int protocol, uint32_t state_mask, char* buf, size_t capacity, Fn on_socket) {
+        if (fd_ < 0) return false;
+        struct {
+            struct nlmsghdr header;
+            struct inet_diag_req_v2 request;
+        } message;
+        std::memset(&message, 0, sizeof(message));
+        message.header.nlmsg_len = sizeof(message);
+        message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+        message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        message.header.nlmsg_seq = ++seq_;
+        message.request.sdiag_family = static_cast<uint8_t>(family);
+        message.request.sdiag_protocol = static_cast<uint8_t>(protocol);
+        message.request.idiag_states = state_mask;
+
+        struct sockaddr_nl kernel;
+        std::memset(&kernel, 0, sizeof(kernel));
+        kernel.nl_family = AF_NETLINK;
+        if (sendto(fd_, &message, sizeof(message), 0, reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+            return false;
+        }
+
+        while (true) {
+            ssize_t length = recv(fd_, buf, capacity, 0);
+            if (length < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            int remaining = static_cast<int>(length);
+            for (auto* header = reinterpret_cast<struct nlmsghdr*>(buf); NLMSG_OK(header, remaining);
+                 header = NLMSG_NEXT(header, remaining)) {
+                if (header->nlmsg_seq != seq_) continue;
+                if (header->nlmsg_type == NLMSG_DONE) return true;
+                if (header->nlmsg_type == NLMSG_ERROR) return false;
+                if (header->nlmsg_type == SOCK_DIAG_BY_FAMILY) {
+                    on_socket(static_cast<const struct inet_diag_msg*>(NLMSG_DATA(header)));
+                }
+            }
+        }
+    }
+
+    int fd_ = -1;
+    uint32_t seq_ = 0;
+};
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef STATS_HISTORY_H
+#define STATS_HISTORY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <mutex>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "error_handler.h"
+#include "hardware_monitor.h"
+
+enum class HistoryMetric {
+    CPU,
+    MEMORY,
+    DISK,
+    DISK_READ,
+    DISK_WRITE,
+    DISK_BUSY,
+    GPU,
+    LOAD,
+    CPU_TEMP,
+    GPU_TEMP,
+    NETWORK_RX,
+    NETWORK_TX,
+    CONNECTIONS,
+    METRIC_COUNT
+};
+
+struct HistoryPoint {
+    int64_t time = 0; // Start of the bucket, seconds since the epoch
+    float min = 0.0f;
+    float avg = 0.0f;
+    float max = 0.0f;
+};
+
+// Fixed-memory history of every HardwareStats figure. Each sample is folded
+// into three rings at once (1 s for an hour, 1 min for a day, 1 h for a
+// month), so min/avg/max rollups are always current and a query never has
+// to aggregate raw samples.
+class StatsHistory {
+public:
+    static constexpr int LEVEL_COUNT = 3;
+    static constexpr int METRIC_COUNT = static_cast<int>(HistoryMetric::METRIC_COUNT);
+    static constexpr uint32_t FILE_VERSION = 2;
+    static constexpr size_t MIN_QUERY_POINTS = 60;
+
+    StatsHistory() {
+        static const int resolutions[LEVEL_COUNT] = {1, 60, 3600};
+        static const size_t capacities[LEVEL_COUNT] = {3600, 1440, 720};
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            levels_[i].resolution = resolutions[i];
+            levels_[i].slots.assign(capacities[i], -1);
+            levels_[i].counts.assign(capacities[i], 0);
+            levels_[i].rollups.resize(capacities[i] * METRIC_COUNT);
+        }
+    }
+
+    // The history the GUI records into and saves
+    static StatsHistory& shared() {
+        static StatsHistory history;
+        return history;
+    }
+
+    void record(int64_t now, const HardwareStats& stats) {
+        float values[METRIC_COUNT];
+        for (int m = 0; m < METRIC_COUNT; m++) values[m] = value_of(static_cast<HistoryMetric>(m), stats);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Level& level : levels_) {
+            int64_t slot = now / level.resolution;
+            size_t index = static_cast<size_t>(slot) % level.slots.size();
+            Rollup* rollups = &level.rollups[index * METRIC_COUNT];
+            if (level.slots[index] != slot) {
+                // Bucket last held a slot one lap ago (or never): start over
+                level.slots[index] = slot;
+                level.counts[index] = 0;
+            }
+            uint32_t count = ++level.counts[index];
+            for (int m = 0; m < METRIC_COUNT; m++) {
+                Rollup& rollup = rollups[m];
+                if (count == 1) {
+                    rollup.min = rollup.max = rollup.mean = values[m];
+                } else {
+                    rollup.min = std::min(rollup.min, values[m]);
+                    rollup.max = std::max(rollup.max, values[m]);
+                    rollup.mean += (values[m] - rollup.mean) / count;
+                }
+            }
+        }
+    }
+
+    // Buckets of metric within (now - window, now], oldest first, from the
+    // coarsest level that still gives MIN_QUERY_POINTS points over the window
+    std::vector<HistoryPoint> query(HistoryMetric metric, int64_t window, int64_t now, int* resolution = nullptr) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int chosen = LEVEL_COUNT - 1;
+        for (int i = 0; i < LEVEL_COUNT; i++) {
+            if (span(levels_[i]) >= window) {
+                chosen = i;
+                break;
+            }
+        }
+        while (chosen + 1 < LEVEL_COUNT &&
+               static_cast<size_t>(window / levels_[chosen + 1].resolution) >= MIN_QUERY_POINTS) {
+            chosen++;
+        }
+
+        const Level& level = levels_[chosen];
+        if (resolution) *resolution = level.resolution;
+        int64_t last = now / level.resolution;
+        int64_t first = std::max<int64_t>((now - window) / level.resolution + 1, last - static_cast<int64_t>(level.slots.size()) + 1);
+        std::vector<HistoryPoint> points;
+        for (int64_t slot = first; slot <= last; slot++) {
+            size_t index = static_cast<size_t>(slot) % level.slots.size();
+            if (level.slots[index] != slot || level.counts[index] == 0) continue;
+            const Rollup& rollup = level.rollups[index * METRIC_COUNT + static_cast<int>(metric)];
+            points.push_back({slot * level.resolution, rollup.min, rollup.mean, rollup.max});
+        }
+        return points;
+    }
+
+    // Binary snapshot: a header, then per level only the buckets in use.
+    // Host byte order; the file is per-user state and never leaves the machine.
+    bool save(const std::string& path) const {
+        if (!make_parent_dirs(path)) {
+            ErrorHandler::handle_file_error(path, "history directory create");
+            return false;
+        }
+        std::string tmp = path + "." + std::to_string(getpid());
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                ErrorHandler::handle_file_error(tmp, "history write");
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            file.write(MAGIC, sizeof(MAGIC));
+            put(file, FILE_VERSION);
+            put(file, static_cast<uint32_t>(METRIC_COUNT));
+            put(file, static_cast<uint32_t>(LEVEL_COUNT));
+            for (const Level& level : levels_) {
+                uint32_t used = static_cast<uint32_t>(
+                    std::count_if(level.counts.begin(), level.counts.end(), [](uint32_t count) { return count > 0; }));
+                put(file, static_cast<uint32_t>(level.resolution));
+                put(file, static_cast<uint32_t>(level.slots.size()));
+                put(file, used);
+                for (size_t index = 0; index < level.slots.size(); index++) {
+                    if (level.counts[index] == 0) continue;
+                    put(file, level.slots[index]);
+                    put(file, level.counts[index]);
+                    file.write(reinterpret_cast<const char*>(&level.rollups[index * METRIC_COUNT]), sizeof(Rollup) * METRIC_COUNT);
+                }
+            }
+            if (!file.good()) {
+                ErrorHandler::handle_file_error(tmp, "history write");
+                unlink(tmp.c_str());
+                return false;
+            }
+        }
+        if (rename(tmp.c_str(), path.c_str()) != 0) {
+            ErrorHandler::handle_file_error(path, "history write");
+            unlink(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Replaces the current contents. A missing file is not an error; a file
+    // from another layout is ignored rather than misread.
+    bool load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        char magic[sizeof(MAGIC)];
+        uint32_t version = 0, metrics = 0, levels = 0;
+        file.read(magic, sizeof(magic));
+        if (!file || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !get(file, version) || !get(file, metrics) ||
+            !get(file, levels) || version != FILE_VERSION || metrics != METRIC_COUNT || levels != LEVEL_COUNT) {
+            ErrorHandler::log_error("Ignoring history file with unknown layout: " + path, ErrorLevel::WARNING);
+            return false;
+        }
+
+        StatsHistory loaded;
+        for (Level& level : loaded.levels_) {
+            uint32_t resolution = 0, capacity = 0, used = 0;
+            if (!get(file, resolution) || !get(file, capacity) || !get(file, used) ||
+                resolution != static_cast<uint32_t>(level.resolution) || capacity != level.slots.size() || used > capacity) {
+                ErrorHandler::log_error("Ignoring damaged history file: " + path, ErrorLevel::WARNING);
+                return false;
+            }
+            for (uint32_t i = 0; i < used; i++) {
+                int64_t slot = 0;
+                uint32_t count = 0;
+                Rollup rollups[METRIC_COUNT];
+                if (!get(file, slot) || !get(file, count) ||
+                    !file.read(reinterpret_cast<char*>(rollups), sizeof(rollups)) || slot < 0) {
+                    ErrorHandler::log_error("Ignoring damaged history file: " + path, ErrorLevel::WARNING);
+                    return false;
+                }
+                size_t index = static_cast<size_t>(slot) % capacity;
+                level.slots[index] = slot;
+                level.counts[index] = count;
+                std::copy(rollups, rollups + METRIC_COUNT, &level.rollups[index * METRIC_COUNT]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < LEVEL_COUNT; i++) levels_[i] = std::move(loaded.levels_[i]);
+        return true;
+    }
+
+    // $XDG_STATE_HOME/archlog or ~/.local/state/archlog; empty when neither is set
+    static std::string default_path() {
+        const char* xdg = getenv("XDG_STATE_HOME");
+        if (xdg && xdg[0] == '/') return std::string(xdg) + "/archlog/hardware_history";
+        const char* home = getenv("HOME");
+        if (home && home[0] == '/') return std::string(home) + "/.local/state/archlog/hardware_history";
+        return "";
+    }
+
+    static const char* name(HistoryMetric metric) {
+        switch (metric) {
+            case HistoryMetric::CPU: return "cpu";
+            case HistoryMetric::MEMORY: return "mem";
+            case HistoryMetric::DISK: return "disk";
+            case HistoryMetric::DISK_READ: return "disk_read";
+            case HistoryMetric::DISK_WRITE: return "disk_write";
+            case HistoryMetric::DISK_BUSY: return "disk_busy";
+            case HistoryMetric::GPU: return "gpu";
+            case HistoryMetric::LOAD: return "load";
+            case HistoryMetric::CPU_TEMP: return "cpu_temp";
+            case HistoryMetric::GPU_TEMP: return "gpu_temp";
+            case HistoryMetric::NETWORK_RX: return "net_rx";
+            case HistoryMetric::NETWORK_TX: return "net_tx";
+            case HistoryMetric::CONNECTIONS: return "connections";
+            default: return "unknown";
+        }
+    }
+
+    static const char* unit(HistoryMetric metric) {
+        switch (metric) {
+            case HistoryMetric::CPU:
+            case HistoryMetric::MEMORY:
+            case HistoryMetric::DISK:
+            case HistoryMetric::DISK_BUSY:
+            case HistoryMetric::GPU: return "%";
+            case HistoryMetric::CPU_TEMP:
+            case HistoryMetric::GPU_TEMP: return "°C";
+            case HistoryMetric::DISK_READ:
+            case HistoryMetric::DISK_WRITE:
+            case HistoryMetric::NETWORK_RX:
+            case HistoryMetric::NETWORK_TX: return "KB/s";
+            default: return "";
+        }
+    }
+
+    static bool parse_metric(const std::string& text, HistoryMetric& metric) {
+        for (int m = 0; m < METRIC_COUNT; m++) {
+            if (text == name(static_cast<HistoryMetric>(m))) {
+                metric = static_cast<HistoryMetric>(m);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // "90", "90s", "15m", "1h", "7d"; 0 when malformed
+    static int64_t parse_window(const std::string& text) {
+        char* end = nullptr;
+        long long value = std::strtoll(text.c_str(), &end, 10);
+        if (end == text.c_str() || value <= 0) return 0;
+        std::string suffix(end);
+        if (suffix.empty() || suffix == "s") return value;
+        if (suffix == "m") return value * 60;
+        if (suffix == "h") return value * 3600;
+        if (suffix == "d") return value * 86400;
+        return 0;
+    }
+
+    // The figure a metric records from one sample
+    static float value_of(HistoryMetric metric, const HardwareStats& stats) {
+        switch (metric) {
+            case HistoryMetric::CPU: return static_cast<float>(stats.cpu_usage);
+            case HistoryMetric::MEMORY: return static_cast<float>(stats.memory_usage);
+            case HistoryMetric::DISK: return static_cast<float>(stats.disk_usage);
+            case HistoryMetric::DISK_READ: return static_cast<float>(stats.disk_read);
+            case HistoryMetric::DISK_WRITE: return static_cast<float>(stats.disk_write);
+            case HistoryMetric::DISK_BUSY: return static_cast<float>(stats.disk_busy);
+            case HistoryMetric::GPU: return static_cast<float>(stats.gpu_usage);
+            case HistoryMetric::LOAD: return std::strtof(stats.system_load.c_str(), nullptr);
+            case HistoryMetric::CPU_TEMP: return static_cast<float>(stats.cpu_temp);
+            case HistoryMetric::GPU_TEMP: return static_cast<float>(stats.gpu_temp);
+            case HistoryMetric::NETWORK_RX: return static_cast<float>(stats.network_rx);
+            case HistoryMetric::NETWORK_TX: return static_cast<float>(stats.network_tx);
+            case HistoryMetric::CONNECTIONS: return static_cast<float>(stats.active_connections);
+            default: return 0.0f;
+        }
+    }
+
+private:
+    struct Rollup {
+        float min = 0.0f;
+        float max = 0.0f;
+        float mean = 0.0f;
+    };
+
+    struct Level {
+        int resolution = 1;            // Seconds per bucket
+        std::vector<int64_t> slots;    // now / resolution the bucket holds, -1 when empty
+        std::vector<uint32_t> counts;  // Samples folded into the bucket
+        std::vector<Rollup> rollups;   // METRIC_COUNT per bucket
+    };
+
+    static constexpr char MAGIC[8] = {'A', 'R', 'C', 'H', 'H', 'I', 'S', 'T'};
+
+    static int64_t span(const Level& level) { return static_cast<int64_t>(level.resolution) * level.slots.size(); }
+
+    template <typename T>
+    static void put(std::ofstream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    static bool get(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    static bool make_parent_dirs(const std::string& path) {
+        for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+            if (mkdir(path.substr(0, slash).c_str(), 0700) != 0 && errno != EEXIST) return false;
+        }
+        return true;
+    }
+
+    mutable std::mutex mutex_;
+    Level levels_[LEVEL_COUNT];
+};
+
+#endif
@@ -3,14 +3,30 @@
 
 #include <string>
 #include <vector>
-#include <map>
+#include <charconv>
+#include <initializer_list>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
+#include <cerrno>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <cstring>
+#include <unistd.h>
+#include "error_handler.h"
+#include "json_escape.h"
+#include "rotating_file.h"
+#include "trace.h"
 
 enum class LogLevel {
     TRACE = 0,
@@ -31,6 +47,57 @@ enum class LogCategory {
     PERFORMANCE
 };
 
+// Key/value pairs in insertion order; the first INLINE_FIELDS live inside
+// the object, so typical metadata costs no allocation beyond its strings
+class LogMetadata {
+public:
+    static constexpr size_t INLINE_FIELDS = 4;
+
+    struct Field {
+        std::string key;
+        std::string value;
+    };
+
+    LogMetadata() = default;
+    LogMetadata(std::initializer_list<Field> fields) {
+        for (const Field& field : fields) set(field.key, field.value);
+    }
+
+    // Replaces the value of an existing key
+    void set(const std::string& key, const std::string& value) {
+        for (size_t i = 0; i < size_; i++) {
+            if ((*this)[i].key == key) {
+                (*this)[i].value = value;
+                return;
+            }
+        }
+        if (size_ < INLINE_FIELDS) {
+            inline_[size_] = Field{key, value};
+        } else {
+            overflow_.push_back(Field{key, value});
+        }
+        size_++;
+    }
+
+    const std::string* find(const std::string& key) const {
+        for (size_t i = 0; i < size_; i++) {
+            if ((*this)[i].key == key) return &(*this)[i].value;
+        }
+        return nullptr;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    Field& operator[](size_t i) { return i < INLINE_FIELDS ? inline_[i] : overflow_[i - INLINE_FIELDS]; }
+    const Field& operator[](size_t i) const { return i < INLINE_FIELDS ? inline_[i] : overflow_[i - INLINE_FIELDS]; }
+
+private:
+    Field inline_[INLINE_FIELDS];
+    std::vector<Field> overflow_;
+    size_t size_ = 0;
+};
+
 struct StructuredLogEntry {
     std::string timestamp;
     std::string log_name;
@@ -42,60 +109,98 @@ struct StructuredLogEntry {
     int line_number;
     std::string user;
     std::string session_id;
-    std::map<std::string, std::string> metadata;
+    LogMetadata metadata;
     
-    std::string to_json() const {
-        std::stringstream json;
-        json << "{"
-             << "\"timestamp\":\"" << timestamp << "\","
-             << "\"log_name\":\"" << log_name << "\","
-             << "\"directory\":\"" << directory << "\","
-             << "\"level\":\"" << level_to_string(level) << "\","
-             << "\"category\":\"" << category_to_string(category) << "\","
-             << "\"message\":\"" << escape_json(message) << "\","
-             << "\"source\":\"" << source_file << ":" << line_number << "\","
-             << "\"user\":\"" << user << "\","
-             << "\"session\":\"" << session_id << "\"";
+    // One line of JSON appended to out; every string field is escaped. The
+    // worst case is reserved once and written through a raw pointer, so a
+    // reused buffer costs no allocation and no per-field capacity checks.
+    void append_json(std::string& out) const {
+        size_t strings = timestamp.size() + log_name.size() + directory.size() + message.size() +
+                         source_file.size() + user.size() + session_id.size();
+        for (size_t i = 0; i < metadata.size(); i++) strings += metadata[i].key.size() + metadata[i].value.size();
+        size_t start = out.size();
+        out.resize(start + JSON_FIXED_BYTES + 8 * metadata.size() + strings * JsonEscape::MAX_EXPANSION);
+        
+        char* p = &out[start];
+        p = put(p, "{\"timestamp\":\"");
+        p = JsonEscape::write(p, timestamp.data(), timestamp.size());
+        p = put(p, "\",\"log_name\":\"");
+        p = JsonEscape::write(p, log_name.data(), log_name.size());
+        p = put(p, "\",\"directory\":\"");
+        p = JsonEscape::write(p, directory.data(), directory.size());
+        p = put(p, "\",\"level\":\"");
+        p = put(p, level_to_string(level));
+        p = put(p, "\",\"category\":\"");
+        p = put(p, category_to_string(category));
+        p = put(p, "\",\"message\":\"");
+        p = JsonEscape::write(p, message.data(), message.size());
+        p = put(p, "\",\"source\":\"");
+        p = JsonEscape::write(p, source_file.data(), source_file.size());
+        *p++ = ':';
+        p = std::to_chars(p, p + 12, line_number).ptr;
+        p = put(p, "\",\"user\":\"");
+        p = JsonEscape::write(p, user.data(), user.size());
+        p = put(p, "\",\"session\":\"");
+        p = JsonEscape::write(p, session_id.data(), session_id.size());
+        *p++ = '"';
         
         if (!metadata.empty()) {
-            json << ",\"metadata\":{";
-            bool first = true;
-            for (const auto& [key, value] : metadata) {
-                if (!first) json << ",";
-                json << "\"" << key << "\":\"" << escape_json(value) << "\"";
-                first = false;
+            p = put(p, ",\"metadata\":{");
+            for (size_t i = 0; i < metadata.size(); i++) {
+                if (i > 0) *p++ = ',';
+                *p++ = '"';
+                p = JsonEscape::write(p, metadata[i].key.data(), metadata[i].key.size());
+                p = put(p, "\":\"");
+                p = JsonEscape::write(p, metadata[i].value.data(), metadata[i].value.size());
+                *p++ = '"';
             }
-            json << "}";
+            *p++ = '}';
         }
-        
-        json << "}";
-        return json.str();
+        *p++ = '}';
+        out.resize(static_cast<size_t>(p - out.data()));
     }
     
-    std::string to_formatted_string() const {
-        std::stringstream ss;
-        ss << "[" << timestamp << "] "
-           << "[" << level_to_string(level) << "] "
-           << "[" << category_to_string(category) << "] "
-           << log_name << " (" << directory << ") "
-           << "| " << message;
+    void append_formatted(std::string& out) const {
+        out += '[';
+        out += timestamp;
+        out.append("] [", 3);
+        out += level_to_string(level);
+        out.append("] [", 3);
+        out += category_to_string(category);
+        out.append("] ", 2);
+        out += log_name;
+        out.append(" (", 2);
+        out += directory;
+        out.append(") | ", 4);
+        out += message;
         
         if (!metadata.empty()) {
-            ss << " {";
-            bool first = true;
-            for (const auto& [key, value] : metadata) {
-                if (!first) ss << ", ";
-                ss << key << "=" << value;
-                first = false;
+            out.append(" {", 2);
+            for (size_t i = 0; i < metadata.size(); i++) {
+                if (i > 0) out.append(", ", 2);
+                out += metadata[i].key;
+                out += '=';
+                out += metadata[i].value;
             }
-            ss << "}";
+            out += '}';
         }
-        
-        return ss.str();
+    }
+    
+    std::string to_json() const {
+        std::string& buffer = scratch();
+        buffer.clear();
+        append_json(buffer);
+        return buffer;
+    }
+    
+    std::string to_formatted_string() const {
+        std::string& buffer = scratch();
+        buffer.clear();
+        append_formatted(buffer);
+        return buffer;
     }
 
-private:
-    std::string level_to_string(LogLevel level) const {
+    static const char* level_to_string(LogLevel level) {
         switch (level) {
             case LogLevel::TRACE: return "TRACE";
             case LogLevel::DEBUG: return "DEBUG";
@@ -107,7 +212,7 @@ private:
         }
     }
     
-    std::string category_to_string(LogCategory cat) const {
+    static const char* category_to_string(LogCategory cat) {
         switch (cat) {
             case LogCategory::SYSTEM: return "SYSTEM";
             case LogCategory::SECURITY: return "SECURITY";
@@ -119,64 +224,249 @@ private:
             default: return "UNKNOWN";
         }
     }
+
+private:
+    // Per-thread buffer behind to_json()/to_formatted_string(); keeps its capacity
+    static std::string& scratch() {
+        thread_local std::string buffer;
+        return buffer;
+    }
     
-    std::string escape_json(const std::string& str) const {
-        std::string escaped;
-        for (char c : str) {
-            switch (c) {
-                case '"': escaped += "\\\""; break;
-                case '\\': escaped += "\\\\"; break;
-                case '\n': escaped += "\\n"; break;
-                case '\r': escaped += "\\r"; break;
-                case '\t': escaped += "\\t"; break;
-                default: escaped += c; break;
-            }
-        }
-        return escaped;
+    // Keys, punctuation, level, category and line number
+    static constexpr size_t JSON_FIXED_BYTES = 192;
+    
+    template <size_t N>
+    static char* put(char* p, const char (&literal)[N]) {
+        std::memcpy(p, literal, N - 1);
+        return p + N - 1;
+    }
+    
+    static char* put(char* p, const char* text) {
+        size_t length = std::strlen(text);
+        std::memcpy(p, text, length);
+        return p + length;
     }
 };
 
+// Levels below this are compiled out of the ARCHLOG_* macros
+// (`make LOG_LEVEL=2` keeps INFO and above)
+#ifndef ARCHLOG_MIN_LOG_LEVEL
+#define ARCHLOG_MIN_LOG_LEVEL 0
+#endif
+
+// "{}" placeholders filled in order; used for deferred messages
+namespace LogMessage {
+    inline void append(std::string& out, const std::string& value) { out += value; }
+    inline void append(std::string& out, char value) { out += value; }
+    inline void append(std::string& out, bool value) { out += value ? "true" : "false"; }
+
+    template <typename T>
+    void append(std::string& out, T value) {
+        static_assert(std::is_arithmetic_v<T>, "log arguments are strings, characters or numbers");
+        char text[32];
+        int length;
+        if constexpr (std::is_floating_point_v<T>) {
+            length = snprintf(text, sizeof(text), "%g", static_cast<double>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            length = snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+        } else {
+            length = snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        }
+        out.append(text, static_cast<size_t>(length));
+    }
+
+    inline void format(std::string& out, const char* pattern) { out += pattern; }
+
+    template <typename T, typename... Rest>
+    void format(std::string& out, const char* pattern, const T& value, const Rest&... rest) {
+        const char* slot = std::strstr(pattern, "{}");
+        if (!slot) {
+            out += pattern;
+            return;
+        }
+        out.append(pattern, static_cast<size_t>(slot - pattern));
+        append(out, value);
+        format(out, slot + 2, rest...);
+    }
+
+    // C strings are copied: the caller's buffer may be gone by the time the writer formats
+    template <typename T>
+    using Capture = std::conditional_t<std::is_same_v<std::decay_t<T>, const char*> ||
+                                       std::is_same_v<std::decay_t<T>, char*>, std::string, std::decay_t<T>>;
+}
+
+// Producers hand records to a lock-free multi-producer queue (Vyukov's
+// intrusive MPSC list) and return; one writer thread formats them and writes
+// each batch with a single write(2) per destination to stdout and a
+// RotatingFile in the log directory.
+//
+// Flush policy: the writer drains at least every FLUSH_INTERVAL_MS, ERROR
+// and above wake it at once, FATAL blocks until it is written, and the queue
+// is drained at exit. Records still queued when the process crashes are
+// lost. When MAX_PENDING records are waiting, new ones are dropped and the
+// count is reported in the log.
 class StructuredLogger {
+public:
+    static constexpr size_t MAX_PENDING = 65536;
+    static constexpr int FLUSH_INTERVAL_MS = 50;
+
 private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::chrono::system_clock::time_point time;
+        StructuredLogEntry entry;
+
+        virtual ~Node() = default;
+        virtual void render() {} // Fills in the parts a deferred record left for the writer
+    };
+
+    // Format string and arguments captured by value, formatted on the writer
+    template <typename... Args>
+    struct DeferredNode : Node {
+        const char* log_name;
+        const char* directory;
+        const char* file;
+        const char* pattern;
+        std::tuple<Args...> args;
+
+        template <typename... Values>
+        DeferredNode(const char* name, const char* dir, const char* source, const char* format, Values&&... values)
+            : log_name(name), directory(dir), file(source), pattern(format), args(std::forward<Values>(values)...) {}
+
+        void render() override {
+            entry.log_name = log_name;
+            entry.directory = directory;
+            entry.source_file = file;
+            std::apply([this](const Args&... values) { LogMessage::format(entry.message, pattern, values...); }, args);
+        }
+    };
+
     static std::string session_id;
     static std::string current_user;
-    static LogLevel min_level;
-    static bool json_output;
+    static std::atomic<LogLevel> min_level;
+    static std::atomic<bool> json_output;
+    static std::atomic<bool> console_output;
     static std::string log_directory;
+    static RotationPolicy rotation;
+    static std::mutex config_mutex;     // Guards the strings above once the writer runs
+
+    static Node stub;
+    static std::atomic<Node*> head;     // Producers swap themselves in here
+    static Node* tail;                  // Writer thread only
+    static std::atomic<size_t> pending;
+    static std::atomic<uint64_t> dropped;         // Since the writer last reported
+    static std::atomic<uint64_t> dropped_total;   // Since startup
+    static std::atomic<bool> stopping;
+    static std::atomic<bool> stopped;   // Writer gone; log() writes synchronously
+    static std::mutex wake_mutex;
+    static std::condition_variable wake;
+    static std::condition_variable drained;
+    static std::thread writer;
+    static std::once_flag started;
 
 public:
     static void initialize(const std::string& user = "", const std::string& log_dir = "/tmp/archlog") {
-        current_user = user.empty() ? get_current_user() : user;
-        session_id = generate_session_id();
-        log_directory = log_dir;
+        {
+            std::lock_guard<std::mutex> lock(config_mutex);
+            current_user = user.empty() ? get_current_user() : user;
+            session_id = generate_session_id();
+            log_directory = log_dir;
+        }
         min_level = LogLevel::INFO;
         json_output = false;
+        start();
     }
     
     static void set_level(LogLevel level) { min_level = level; }
     static void set_json_output(bool enable) { json_output = enable; }
+    static void set_console_output(bool enable) { console_output = enable; }
+    
+    static void set_rotation(const RotationPolicy& policy) {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        rotation = policy;
+    }
     
     static void log(LogLevel level, LogCategory category, const std::string& log_name,
                    const std::string& directory, const std::string& message,
                    const std::string& file = "", int line = 0,
-                   const std::map<std::string, std::string>& metadata = {}) {
+                   const LogMetadata& metadata = {}) {
         
-        if (level < min_level) return;
+        if (!enabled(level) || !reserve(level)) return;
         
-        StructuredLogEntry entry;
-        entry.timestamp = get_current_timestamp();
+        Node* node = new Node;
+        StructuredLogEntry& entry = node->entry;
         entry.log_name = log_name;
         entry.directory = directory;
-        entry.level = level;
         entry.category = category;
         entry.message = message;
         entry.source_file = file;
         entry.line_number = line;
-        entry.user = current_user;
-        entry.session_id = session_id;
         entry.metadata = metadata;
+        enqueue(node, level);
+    }
+    
+    static bool enabled(LogLevel level) { return level >= min_level.load(std::memory_order_relaxed); }
+    
+    // Front-end of the ARCHLOG_* macros: nothing is formatted or concatenated
+    // here. log_name, directory and file must be string literals.
+    template <typename... Args>
+    static void log_deferred(LogLevel level, LogCategory category, const char* log_name, const char* directory,
+                             const char* file, int line, const char* pattern, Args&&... args) {
+        if (!reserve(level)) return;
+        auto node = new DeferredNode<LogMessage::Capture<Args>...>(log_name, directory, file, pattern,
+                                                                  std::forward<Args>(args)...);
+        node->entry.category = category;
+        node->entry.line_number = line;
+        enqueue(node, level);
+    }
+    
+private:
+    // Holds a queue slot, or counts the record as dropped
+    static bool reserve(LogLevel level) {
+        start();
+        if (pending.fetch_add(1, std::memory_order_relaxed) >= MAX_PENDING && level < LogLevel::FATAL) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            dropped_total.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+    
+    static void enqueue(Node* node, LogLevel level) {
+        node->time = std::chrono::system_clock::now();
+        node->entry.level = level;
+        if (stopped.load(std::memory_order_acquire)) {
+            write_now(node);
+            return;
+        }
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
         
-        output_log(entry);
+        if (level >= LogLevel::ERROR) wake.notify_one();
+        if (level == LogLevel::FATAL) flush();
+    }
+    
+public:
+    // Records lost to a full queue since startup
+    static uint64_t dropped_records() { return dropped_total.load(std::memory_order_relaxed); }
+
+    // Blocks until every record queued so far has been written
+    static void flush() {
+        if (stopped.load(std::memory_order_acquire)) return;
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.notify_one();
+        while (pending.load(std::memory_order_acquire) > 0 && !stopped.load(std::memory_order_acquire)) {
+            drained.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+        }
+    }
+    
+    // Drains the queue and stops the writer; registered with atexit()
+    static void shutdown() {
+        if (!writer.joinable()) return;
+        stopping = true;
+        wake.notify_one();
+        writer.join();
     }
     
     // Convenience methods
@@ -217,17 +507,155 @@ public:
     }
     
     static void performance(const std::string& log_name, const std::string& dir, const std::string& msg,
-                          const std::map<std::string, std::string>& metrics = {}) {
+                          const LogMetadata& metrics = {}) {
         log(LogLevel::INFO, LogCategory::PERFORMANCE, log_name, dir, msg, "", 0, metrics);
     }
     
     static void user_action(const std::string& action, const std::string& details = "") {
-        std::map<std::string, std::string> metadata;
-        if (!details.empty()) metadata["details"] = details;
+        LogMetadata metadata;
+        if (!details.empty()) metadata.set("details", details);
         log(LogLevel::INFO, LogCategory::USER_ACTION, "user_interface", "/gui", action, "", 0, metadata);
     }
 
 private:
+    static void start() {
+        std::call_once(started, [] {
+            std::atexit(shutdown);
+            writer = std::thread(run);
+        });
+    }
+    
+    // Oldest linked record, or nullptr; a producer that has swapped head but
+    // not yet linked its node is picked up on the next pass
+    static Node* pop() {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return nullptr;
+        if (tail != &stub) delete tail;
+        tail = next;
+        return next;
+    }
+    
+    static void run() {
+        Tracer::set_thread_name("structured log");
+        Formatter formatter;
+        std::string text;
+        while (true) {
+            bool stop = stopping.load(std::memory_order_acquire);
+            size_t count = 0;
+            formatter.configure();
+            while (Node* node = pop()) {
+                formatter.append(text, node);
+                count++;
+            }
+            uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+            if (lost > 0) {
+                text += "[" + get_current_timestamp() + "] [WARN] [SYSTEM] structured_logger | Queue full, dropped " +
+                        std::to_string(lost) + " records\n";
+            }
+            if (!text.empty()) {
+                formatter.write(text);
+                text.clear();
+            }
+            if (count > 0) {
+                pending.fetch_sub(count, std::memory_order_release);
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                drained.notify_all();
+                continue;
+            }
+            if (stop) break;
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+        }
+        
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopped = true;
+        drained.notify_all();
+    }
+    
+    // Writer-side state: identity, the log file and the last formatted second
+    class Formatter {
+    public:
+        void configure() {
+            std::lock_guard<std::mutex> lock(config_mutex);
+            user_ = current_user;
+            session_ = session_id;
+            if (directory_ != log_directory) {
+                directory_ = log_directory;
+                file_.reset(directory_.empty() ? nullptr : new RotatingFile(directory_, "archlog", rotation));
+            } else if (file_) {
+                file_->set_policy(rotation);
+            }
+        }
+        
+        void append(std::string& text, Node* node) {
+            node->render();
+            StructuredLogEntry& entry = node->entry;
+            entry.timestamp = timestamp(node->time);
+            entry.user = user_;
+            entry.session_id = session_;
+            if (json_output.load(std::memory_order_relaxed)) {
+                entry.append_json(text);
+            } else {
+                entry.append_formatted(text);
+            }
+            text += '\n';
+        }
+        
+        void write(const std::string& text) {
+            if (console_output.load(std::memory_order_relaxed)) write_all(STDOUT_FILENO, text);
+            if (file_) file_->write(text.data(), text.size());
+        }
+        
+    private:
+        
+        std::string timestamp(std::chrono::system_clock::time_point time) {
+            time_t seconds = std::chrono::system_clock::to_time_t(time);
+            if (seconds != second_) {
+                struct tm local;
+                localtime_r(&seconds, &local);
+                strftime(second_text_, sizeof(second_text_), "%Y-%m-%d %H:%M:%S", &local);
+                second_ = seconds;
+            }
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+            char text[40];
+            snprintf(text, sizeof(text), "%s.%03d", second_text_, static_cast<int>(ms));
+            return text;
+        }
+        
+        static bool write_all(int fd, const std::string& text) {
+            const char* data = text.data();
+            size_t length = text.size();
+            while (length > 0) {
+                ssize_t n = ::write(fd, data, length);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                data += n;
+                length -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+        
+        std::string user_, session_, directory_;
+        std::unique_ptr<RotatingFile> file_;
+        time_t second_ = -1;
+        char second_text_[32] = {};
+    };
+    
+    // After shutdown: stragglers from detached threads are written in place
+    static void write_now(Node* node) {
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        static Formatter formatter;
+        std::string text;
+        formatter.configure();
+        formatter.append(text, node);
+        formatter.write(text);
+        delete node;
+        pending.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
     static std::string get_current_timestamp() {
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -250,31 +678,44 @@ private:
         const char* user = getenv("USER");
         return user ? std::string(user) : "unknown";
     }
-    
-    static void output_log(const StructuredLogEntry& entry) {
-        std::string output = json_output ? entry.to_json() : entry.to_formatted_string();
-        
-        // Output to console
-        std::cout << output << std::endl;
-        
-        // Also save to file
-        std::string filename = log_directory + "/archlog_" + 
-                              std::to_string(std::chrono::system_clock::to_time_t(
-                                  std::chrono::system_clock::now())) + ".log";
-        
-        std::ofstream logfile(filename, std::ios::app);
-        if (logfile.is_open()) {
-            logfile << output << std::endl;
-            logfile.close();
-        }
-    }
 };
 
 // Static member definitions
 std::string StructuredLogger::session_id;
 std::string StructuredLogger::current_user;
-LogLevel StructuredLogger::min_level = LogLevel::INFO;
-bool StructuredLogger::json_output = false;
+std::atomic<LogLevel> StructuredLogger::min_level{LogLevel::INFO};
+std::atomic<bool> StructuredLogger::json_output{false};
+std::atomic<bool> StructuredLogger::console_output{true};
 std::string StructuredLogger::log_directory = "/tmp/archlog";
+RotationPolicy StructuredLogger::rotation;
+std::mutex StructuredLogger::config_mutex;
+StructuredLogger::Node StructuredLogger::stub;
+std::atomic<StructuredLogger::Node*> StructuredLogger::head{&StructuredLogger::stub};
+StructuredLogger::Node* StructuredLogger::tail = &StructuredLogger::stub;
+std::atomic<size_t> StructuredLogger::pending{0};
+std::atomic<uint64_t> StructuredLogger::dropped{0};
+std::atomic<uint64_t> StructuredLogger::dropped_total{0};
+std::atomic<bool> StructuredLogger::stopping{false};
+std::atomic<bool> StructuredLogger::stopped{false};
+std::mutex StructuredLogger::wake_mutex;
+std::condition_variable StructuredLogger::wake;
+std::condition_variable StructuredLogger::drained;
+std::thread StructuredLogger::writer;
+std::once_flag StructuredLogger::started;
+
+#define ARCHLOG_LOG(level, category, log_name, directory, ...)                                              \
+    do {                                                                                                     \
+        if constexpr (static_cast<int>(level) >= ARCHLOG_MIN_LOG_LEVEL) {                                    \
+            if (StructuredLogger::enabled(level)) {                                                          \
+                StructuredLogger::log_deferred(level, category, log_name, directory, __FILE__, __LINE__, __VA_ARGS__); \
+            }                                                                                                \
+        }                                                                                                    \
+    } while (0)
+
+#define ARCHLOG_TRACE(log_name, directory, ...) ARCHLOG_LOG(LogLevel::TRACE, LogCategory::APPLICATION, log_name, directory, __VA_ARGS__)
+#define ARCHLOG_DEBUG(log_name, directory, ...) ARCHLOG_LOG(LogLevel::DEBUG, LogCategory::APPLICATION, log_name, directory, __VA_ARGS__)
+#define ARCHLOG_INFO(log_name, directory, ...) ARCHLOG_LOG(LogLevel::INFO, LogCategory::APPLICATION, log_name, directory, __VA_ARGS__)
+#define ARCHLOG_WARN(log_name, directory, ...) ARCHLOG_LOG(LogLevel::WARN, LogCategory::APPLICATION, log_name, directory, __VA_ARGS__)
+#define ARCHLOG_ERROR(log_name, directory, ...) ARCHLOG_LOG(LogLevel::ERROR, LogCategory::APPLICATION, log_name, directory, __VA_ARGS__)
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,240 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "error_handler.h"
+#include "monotonic_clock.h"
+
+// Span recorder for --trace-out. Every thread appends to its own chunked
+// buffer (single writer, no locks); write_chrome_trace() walks all buffers
+// and emits Chrome trace-event JSON that Perfetto and chrome://tracing load.
+// A thread's buffer goes on a free list when it exits and the next new
+// thread continues it, so short-lived workers do not each cost a buffer.
+// Span names and categories must be string literals.
+class Tracer {
+public:
+    static void enable() { enabled_.store(true, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static uint64_t now_ns() { return MonotonicClock::now_ns(); }
+
+    // Completed span on the calling thread
+    static void complete(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns) {
+        if (!enabled()) return;
+        append(name, category, start_ns, end_ns, false);
+    }
+
+    // Span that starts on one thread and ends on another, e.g. the wait
+    // between g_idle_add() and the main loop running the callback
+    static void async(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns) {
+        if (!enabled()) return;
+        append(name, category, start_ns, end_ns, true);
+    }
+
+    static void set_thread_name(const char* name) {
+        if (!enabled() || exited_) return;
+        local_buffer()->name.store(name, std::memory_order_release);
+    }
+
+    static bool write_chrome_trace(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            ErrorHandler::handle_system_error("trace output " + path, errno);
+            return false;
+        }
+
+        int pid = static_cast<int>(getpid());
+        uint64_t dropped = 0;
+        bool first = true;
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        {
+            std::lock_guard<std::mutex> lock(free_mutex_);
+            for (const ThreadName& retired : retired_names_) {
+                write_thread_name(file, pid, retired.tid, retired.name, first);
+                first = false;
+            }
+        }
+        for (ThreadBuffer* buffer = buffers_.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+            const char* name = buffer->name.load(std::memory_order_acquire);
+            if (name) {
+                write_thread_name(file, pid, buffer->tid.load(std::memory_order_acquire), name, first);
+                first = false;
+            }
+            for (Chunk* chunk = buffer->head.load(std::memory_order_acquire); chunk;
+                 chunk = chunk->next.load(std::memory_order_acquire)) {
+                size_t count = chunk->count.load(std::memory_order_acquire);
+                for (size_t i = 0; i < count; i++) {
+                    write_event(file, chunk->events[i], pid, first);
+                    first = false;
+                }
+            }
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+        std::fprintf(file, "\n]}\n");
+
+        bool ok = std::fflush(file) == 0;
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            ErrorHandler::handle_system_error("trace output " + path, errno);
+        } else if (dropped > 0) {
+            ErrorHandler::log_error("Trace buffers full, dropped " + std::to_string(dropped) + " spans", ErrorLevel::WARNING);
+        }
+        return ok;
+    }
+
+private:
+    // Chunks start small and double, so a thread that records a few spans
+    // costs a few KB
+    static constexpr size_t FIRST_CHUNK_EVENTS = 64;
+    static constexpr size_t MAX_CHUNK_EVENTS = 4096;
+    static constexpr size_t MAX_EVENTS_PER_BUFFER = 1 << 20;
+
+    struct Event {
+        const char* name;
+        const char* category;
+        uint64_t start_ns;
+        uint64_t end_ns;
+        uint64_t async_id; // 0 for spans that begin and end on this thread
+        int tid;           // Buffers outlive threads, so each event keeps its own
+    };
+
+    struct Chunk {
+        explicit Chunk(size_t size) : events(new Event[size]), capacity(size) {}
+        std::unique_ptr<Event[]> events;
+        size_t capacity;
+        std::atomic<size_t> count{0};
+        std::atomic<Chunk*> next{nullptr};
+    };
+
+    struct ThreadBuffer {
+        std::atomic<int> tid{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<Chunk*> head{nullptr};
+        Chunk* tail = nullptr;
+        size_t events = 0;
+        std::atomic<uint64_t> dropped{0};
+        ThreadBuffer* next = nullptr;      // All buffers, never unlinked
+        ThreadBuffer* next_free = nullptr;
+    };
+
+    struct ThreadName {
+        int tid;
+        const char* name;
+    };
+
+    // Hands the buffer back when its thread exits
+    struct LocalHandle {
+        ThreadBuffer* buffer = nullptr;
+        ~LocalHandle() {
+            exited_ = true; // Spans from later thread_local destructors are dropped
+            if (!buffer) return;
+            std::lock_guard<std::mutex> lock(free_mutex_);
+            const char* name = buffer->name.exchange(nullptr, std::memory_order_acq_rel);
+            if (name) retired_names_.push_back(ThreadName{buffer->tid.load(std::memory_order_relaxed), name});
+            buffer->next_free = free_buffers_;
+            free_buffers_ = buffer;
+            buffer = nullptr;
+        }
+    };
+
+    // Buffers are never freed: their spans are needed by the dump
+    static ThreadBuffer* local_buffer() {
+        ThreadBuffer* buffer = local_.buffer;
+        if (buffer) return buffer;
+
+        int tid = static_cast<int>(syscall(SYS_gettid));
+        {
+            std::lock_guard<std::mutex> lock(free_mutex_);
+            buffer = free_buffers_;
+            if (buffer) free_buffers_ = buffer->next_free;
+        }
+        if (buffer) {
+            buffer->tid.store(tid, std::memory_order_release);
+        } else {
+            buffer = new ThreadBuffer;
+            buffer->tid.store(tid, std::memory_order_relaxed);
+            buffer->next = buffers_.load(std::memory_order_relaxed);
+            while (!buffers_.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        local_.buffer = buffer;
+        return buffer;
+    }
+
+    static void append(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns, bool is_async) {
+        if (exited_) return;
+        ThreadBuffer* buffer = local_buffer();
+        Chunk* chunk = buffer->tail;
+        size_t index = chunk ? chunk->count.load(std::memory_order_relaxed) : 0;
+        if (!chunk || index == chunk->capacity) {
+            if (buffer->events >= MAX_EVENTS_PER_BUFFER) {
+                buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            Chunk* fresh = new Chunk(chunk ? std::min(chunk->capacity * 2, MAX_CHUNK_EVENTS) : FIRST_CHUNK_EVENTS);
+            if (chunk) {
+                chunk->next.store(fresh, std::memory_order_release);
+            } else {
+                buffer->head.store(fresh, std::memory_order_release);
+            }
+            buffer->tail = chunk = fresh;
+            index = 0;
+        }
+        uint64_t async_id = is_async ? next_async_id_.fetch_add(1, std::memory_order_relaxed) : 0;
+        chunk->events[index] = Event{name, category, start_ns, end_ns, async_id, buffer->tid.load(std::memory_order_relaxed)};
+        chunk->count.store(index + 1, std::memory_order_release);
+        buffer->events++;
+    }
+
+    static void write_thread_name(FILE* file, int pid, int tid, const char* name, bool first) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", pid, tid, name);
+    }
+
+    static void write_event(FILE* file, const Event& event, int pid, bool first) {
+        int tid = event.tid;
+        const char* sep = first ? "" : ",\n";
+        double ts = event.start_ns / 1000.0;
+        if (event.async_id == 0) {
+            std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                         sep, event.name, event.category, ts, (event.end_ns - event.start_ns) / 1000.0, pid, tid);
+            return;
+        }
+        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"b\",\"id\":%llu,\"ts\":%.3f,\"pid\":%d,\"tid\":%d},\n",
+                     sep, event.name, event.category, static_cast<unsigned long long>(event.async_id), ts, pid, tid);
+        std::fprintf(file, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"e\",\"id\":%llu,\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                     event.name, event.category, static_cast<unsigned long long>(event.async_id), event.end_ns / 1000.0, pid, tid);
+    }
+
+    static std::atomic<bool> enabled_;
+    static std::atomic<ThreadBuffer*> buffers_;
+    static std::atomic<uint64_t> next_async_id_;
+    static std::mutex free_mutex_;
+    static ThreadBuffer* free_buffers_;
+    static std::vector<ThreadName> retired_names_;
+    static thread_local LocalHandle local_;
+    static thread_local bool exited_;
+};
+
+// Static member definitions
+std::atomic<bool> Tracer::enabled_{false};
+std::atomic<Tracer::ThreadBuffer*> Tracer::buffers_{nullptr};
+std::atomic<uint64_t> Tracer::next_async_id_{1};
+std::mutex Tracer::free_mutex_;
+Tracer::ThreadBuffer* Tracer::free_buffers_ = nullptr;
+std::vector<Tracer::ThreadName> Tracer::retired_names_;
+thread_local Tracer::LocalHandle Tracer::local_;
+thread_local bool Tracer::exited_ = false;
+
+#endif